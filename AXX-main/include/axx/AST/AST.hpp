@@ -1,13 +1,24 @@
 #pragma once
+#include <axx/AST/ASTArena.hpp>
 #include <axx/AST/ASTNode.hpp>
 #include <axx/interface/NodeVisitorInterface.hpp>
+#include <axx/token/SourceFile.hpp>
+#include <memory>
 
 class AST
 {
     BaseASTNode *root;
+    std::shared_ptr<const SourceFile> source; // Исходный файл живёт, пока на него ссылается дерево
+    std::unique_ptr<ASTArena> arena; // Все узлы дерева, освобождаются вместе с ним
 
 public:
-    AST(BaseASTNode *root);
+    AST(BaseASTNode *root, std::shared_ptr<const SourceFile> source = nullptr, std::unique_ptr<ASTArena> arena = nullptr);
+    AST(const AST&) = delete;
+    AST& operator=(const AST&) = delete;
     void print();
+    BaseASTNode *getRoot();
+    void setRoot(BaseASTNode *_root);
+    /// @brief Область памяти узлов дерева: новые узлы, которыми заменяются старые, создаются в ней
+    ASTArena *getArena();
     void accept(NodeVisitorInterface *_visitor);
 };
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @brief Область памяти для узлов дерева. Узлы размещаются подряд в крупных блоках
+/// и уничтожаются все сразу вместе с областью, отдельные узлы не освобождаются
+class ASTArena
+{
+private:
+    struct Destructor
+    {
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    std::vector<std::unique_ptr<unsigned char[]>> blocks;
+    std::vector<Destructor> destructors; // Деструкторы вызываются в порядке, обратном созданию
+    unsigned char* cursor = nullptr;
+    std::size_t left = 0; // Свободно байт в текущем блоке
+
+    void* allocate(std::size_t _size, std::size_t _align);
+
+public:
+    ASTArena() = default;
+    ~ASTArena();
+    ASTArena(const ASTArena&) = delete;
+    ASTArena& operator=(const ASTArena&) = delete;
+
+    /// @brief Создаёт узел в области, узел живёт до уничтожения области
+    template <typename T, typename... Args>
+    T* make(Args&&... _args)
+    {
+        void* memory = this->allocate(sizeof(T), alignof(T));
+        T* object = new (memory) T(std::forward<Args>(_args)...);
+        if constexpr (!std::is_trivially_destructible<T>::value)
+        {
+            try
+            {
+                destructors.push_back({object, [](void* _object) { static_cast<T*>(_object)->~T(); }});
+            }
+            catch (...)
+            {
+                object->~T();
+                throw;
+            }
+        }
+        return object;
+    }
+};
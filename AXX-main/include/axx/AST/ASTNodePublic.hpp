@@ -1,5 +1,7 @@
 #pragma once
 
+class BaseASTNode;
+class ExpressionNode;
 class Leaf;
 class FormalParamsNode;
 class ActualParamsNode;
@@ -0,0 +1,83 @@
+#pragma once
+#include <axx/AST/AST.hpp>
+#include <axx/AST/ASTNode.hpp>
+#include <axx/interface/FlatVisitorInterface.hpp>
+#include <axx/token/SourceFile.hpp>
+#include <axx/token/Token.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// @brief Вид узла плоского дерева, соответствует классу из ASTNode.hpp
+enum class NodeKind : std::uint8_t
+{
+    Empty, // Отсутствующий необязательный потомок (например, IfNode без else)
+    VariableDeclaration,
+    Leaf,
+    FormalParams,
+    ActualParams,
+    Call,
+    Binary,
+    Unary,
+    Assignment,
+    Return,
+    Block,
+    Program,
+    Function,
+    Procedure,
+    Else,
+    Elif,
+    If,
+    While,
+    For,
+};
+
+/// @brief Дерево в виде массивов: вид узла, номер токена, первый потомок, следующий брат и число
+/// (размер массива у объявления переменной). Узлы ссылаются друг на друга 32-битными номерами,
+/// корень - узел 0, потомки идут в порядке полей класса узла. Все массивы лежат в одном буфере,
+/// так что дерево копируется одним memcpy. Токены ссылаются на TextStorage и LineIndex, поэтому
+/// буфер имеет смысл только внутри процесса, пока живы исходный файл и Interner
+class FlatAST
+{
+private:
+    std::vector<std::uint32_t> storage;
+    std::uint32_t nodes;
+    std::uint32_t tokens;
+
+    // Смещения массивов в storage, в словах
+    std::size_t kindsAt() const;
+    std::size_t tokenAt() const;
+    std::size_t firstChildAt() const;
+    std::size_t nextSiblingAt() const;
+    std::size_t valueAt() const;
+    std::size_t poolAt() const;
+    void layout(std::uint32_t _nodes, std::uint32_t _tokens);
+
+    BaseASTNode* expand(std::uint32_t _node, ASTArena& _arena) const;
+
+public:
+    static constexpr std::uint32_t NONE = 0xFFFFFFFFu;
+
+    /// @brief Переводит дерево указателей в плоский вид
+    explicit FlatAST(BaseASTNode* _root);
+    /// @brief Восстанавливает дерево из буфера, полученного через data() и bytes()
+    FlatAST(const void* _data, std::size_t _bytes);
+
+    std::uint32_t size() const;
+    NodeKind kind(std::uint32_t _node) const;
+    bool hasToken(std::uint32_t _node) const;
+    Token token(std::uint32_t _node) const;
+    std::uint32_t firstChild(std::uint32_t _node) const;
+    std::uint32_t nextSibling(std::uint32_t _node) const;
+    std::uint32_t value(std::uint32_t _node) const;
+
+    const void* data() const;
+    std::size_t bytes() const;
+
+    /// @brief Строит обычное дерево узлов в собственной области памяти
+    std::unique_ptr<AST> expand(std::shared_ptr<const SourceFile> _source = nullptr) const;
+    /// @brief Обходит дерево по массивам, не строя узлов: узлы лежат в порядке обхода,
+    /// поэтому обход читает массивы подряд, а стек хранит только незакрытых предков
+    void accept(FlatVisitorInterface& _visitor) const;
+};
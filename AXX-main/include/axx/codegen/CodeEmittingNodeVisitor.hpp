@@ -1,22 +1,42 @@
 #pragma once
 #include <axx/interface/NodeVisitorInterface.hpp>
 #include <axx/token/Token.hpp>
-#include <map>
+#include <axx/token/Interner.hpp>
+#include <axx/codegen/OutputBuffer.hpp>
 #include <queue>
 #include <stack>
 #include <utility>
 #include <ostream>
+#include <string_view>
+#include <vector>
 
 class CodeEmittingNodeVisitor : public NodeVisitorInterface
 {
+public:
+    /// @brief Части стандартной библиотеки и среды выполнения, которые нужны выведенному коду
+    enum Feature : unsigned
+    {
+        STRINGS = 1u << 0, // std::string
+        OUTPUT = 1u << 1,  // Put_Line
+        MODULO = 1u << 2,  // axx_rt::mod: mod в Ada берёт знак делителя, а % в C++ - знак делимого
+        ALL_FEATURES = STRINGS | OUTPUT | MODULO,
+    };
+
 private:
-    std::ostream& stream;
-    void write(std::string s);
+    OutputBuffer& output;
+    Interner& interner;
+    std::vector<std::string_view> reserved; // По номеру идентификатора: имена типов Ada, которые в C++ пишутся иначе
+    symbol_t string_type;
+    symbol_t put_line;
+    unsigned int features; // Feature, встреченные при выводе
+    void write(std::string_view s);
     void write(Token token);
     void write(Leaf* leaf);
+    /// @brief Заголовок подпрограммы без точки с запятой, _return_type = nullptr - процедура
+    void signature(Leaf* _return_type, Leaf* _id, FormalParamsNode* _params);
     std::vector<VariableDeclarationNode*> block_declarations;
 public:
-    CodeEmittingNodeVisitor(std::ostream& _stream);
+    CodeEmittingNodeVisitor(OutputBuffer& _output, Interner& _interner);
     void visitLeaf(Leaf *_acceptor);
     void visitFormalParamsNode(FormalParamsNode *_acceptor);
     void visitActualParamsNode(ActualParamsNode *_acceptor);
@@ -35,4 +55,13 @@ public:
     void visitForNode(ForNode *_acceptor);
     void visitVarDeclNode(VariableDeclarationNode *_acceptor);
     void visitReturnNode(ReturnNode *_acceptor);
+
+    /// @brief Заголовок выходного файла: только те заголовки и части среды выполнения, что есть в _features
+    void prologue(unsigned int _features);
+    /// @brief Feature, которые использует код, выведенный этим посетителем
+    unsigned int used() const;
+    /// @brief Инструкция верхнего уровня программы
+    void statement(BaseASTNode *_node);
+    /// @brief Предварительное объявление подпрограммы верхнего уровня, для других инструкций ничего
+    void declaration(BaseASTNode *_node);
 };
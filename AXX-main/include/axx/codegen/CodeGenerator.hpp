@@ -2,16 +2,42 @@
 
 #include <axx/interface/CodeGeneratorInterface.hpp>
 #include <axx/codegen/CodeEmittingNodeVisitor.hpp>
+#include <axx/codegen/OutputBuffer.hpp>
 
 #include <memory>
 #include <ostream>
+#include <string>
+#include <vector>
 
+/// @brief Подпрограммы верхнего уровня выводятся независимо друг от друга, поэтому generate
+/// пишет каждую в свой буфер в нескольких потоках и склеивает буферы в порядке текста:
+/// результат совпадает с последовательным выводом байт в байт. Заголовки файла выбираются
+/// по тому, что встретилось в выведенном коде, поэтому пишутся после вывода тел. Перед телами
+/// идут объявления всех подпрограмм: Ada позволяет вызвать подпрограмму, описанную ниже
 class CodeGenerator : public CodeGeneratorInterface
 {
 private:
+    OutputBuffer output;
+    Interner& interner;
     std::unique_ptr<CodeEmittingNodeVisitor> visitor;
+    unsigned int threads;
+
+    /// @brief Выводит каждую инструкцию _units в свой буфер _parts, возвращает нужные им Feature
+    unsigned int emit(const std::vector<BaseASTNode*>& _units, std::vector<OutputBuffer>& _parts);
+    /// @brief Выводит объявления подпрограмм из _units, возвращает нужные им Feature
+    unsigned int declare(const std::vector<BaseASTNode*>& _units, OutputBuffer& _declarations);
+    static std::vector<BaseASTNode*> units(AST *_ast);
 
 public:
-    CodeGenerator(std::ostream& _stream);
+    /// @brief _threads = 0 - по числу ядер
+    CodeGenerator(std::ostream& _stream, Interner& _interner, unsigned int _threads = 0);
     void generate(AST *_ast);
+    void start();
+    void generateStatement(AST *_statement);
+    void finish();
+    /// @brief Выводит программу в заголовок _base.hpp с объявлениями всех подпрограмм и _shards
+    /// файлов _base_0.cpp ... с телами, близкими по размеру. Подпрограммы идут подряд в порядке
+    /// текста. Файл, содержимое которого не изменилось, не перезаписывается, чтобы make не
+    /// пересобирал его. Поток из конструктора не используется
+    void generateShards(AST *_ast, const std::string& _base, unsigned int _shards);
 };
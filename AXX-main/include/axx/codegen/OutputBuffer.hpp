@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/// @brief Буфер выходного текста: фрагменты дописываются в память и уходят в поток
+/// блоками по CAPACITY байт, а не по одному через operator<<. Буфер без потока
+/// только копит текст, его забирают через text()
+class OutputBuffer
+{
+private:
+    static constexpr std::size_t CAPACITY = 64 * 1024;
+
+    std::ostream* stream;
+    std::string buffer;
+
+public:
+    OutputBuffer();
+    OutputBuffer(std::ostream& _stream);
+    ~OutputBuffer();
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    void append(std::string_view _text);
+    /// @brief Отдаёт накопленный текст потоку
+    void flush();
+    /// @brief Накопленный и ещё не отданный потоку текст
+    std::string_view text() const;
+};
@@ -6,5 +6,11 @@ class CodeGeneratorInterface
 {
 public:
     virtual void generate(AST *_ast) = 0;
+    /// @brief Начало программы при выводе по одной инструкции верхнего уровня
+    virtual void start() = 0;
+    /// @brief Выводит инструкцию верхнего уровня, полученную Parser::getNextStatement
+    virtual void generateStatement(AST *_statement) = 0;
+    /// @brief Конец программы при выводе по одной инструкции: всё выведенное уходит в поток
+    virtual void finish() = 0;
     virtual ~CodeGeneratorInterface() = default;
 };
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+class FlatAST;
+
+/// @brief Посетитель плоского дерева: получает номера узлов в порядке обхода в глубину,
+/// вид, токен и потомков узла читает из массивов FlatAST
+class FlatVisitorInterface
+{
+public:
+    virtual ~FlatVisitorInterface() = default;
+
+    /// @brief Вход в узел; false - потомков узла не обходить
+    virtual bool enter(const FlatAST& _tree, std::uint32_t _node) = 0;
+    /// @brief Выход из узла после всех его потомков
+    virtual void leave(const FlatAST&, std::uint32_t) {}
+};
@@ -1,11 +1,17 @@
 #pragma once
 #include <axx/token/Token.hpp>
+#include <axx/token/SourceFile.hpp>
 #include <axx/interface/LexerStateInterface.hpp>
+#include <istream>
+#include <memory>
+#include <string>
 
 class LexerInterface
 {
 public:
     virtual void open(std::istream& _stream) = 0;
+    virtual void open(const std::string& _path) = 0;
+    virtual std::shared_ptr<const SourceFile> getSource() const = 0;
     virtual Token getToken() = 0;
     virtual void setState(LexerStateInterface *_state) = 0;
     virtual void print_all_tokens() = 0;
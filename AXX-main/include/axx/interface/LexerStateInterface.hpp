@@ -4,5 +4,7 @@ class LexerStateInterface
 {
 public:
     virtual bool recognize(char _ch) = 0;
+    /// @brief Пропускает символы, на которых состояние остаётся прежним, и возвращает первый непрочитанный
+    virtual const char* fastforward(const char* _begin, const char* /* _end */) { return _begin; }
     virtual ~LexerStateInterface() = default;
 };
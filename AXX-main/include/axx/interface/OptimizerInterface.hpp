@@ -0,0 +1,10 @@
+#pragma once
+#include <axx/AST/AST.hpp>
+
+class OptimizerInterface
+{
+public:
+    /// @brief Преобразует проверенное дерево перед генерацией кода
+    virtual void optimize(AST *_ast) = 0;
+    virtual ~OptimizerInterface() = default;
+};
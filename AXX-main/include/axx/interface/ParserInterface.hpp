@@ -7,5 +7,8 @@ class ParserInterface
 public:
     virtual void setLexer(LexerInterface*) = 0;
     virtual AST* getAST() = 0;
+    /// @brief Разбирает следующую инструкцию верхнего уровня в отдельное дерево. Последним
+    /// возвращается лист конца файла, после него - nullptr
+    virtual AST* getNextStatement() = 0;
     virtual ~ParserInterface() = default;
 };
@@ -0,0 +1,21 @@
+#pragma once
+#include <axx/interface/LexerInterface.hpp>
+#include <ostream>
+
+/// @brief Обёртка над лексером, печатающая каждый выданный токен в формате print_all_tokens.
+/// Позволяет вывести токены из того же потока, который читает парсер, без второго прохода по файлу
+class DumpingLexer : public LexerInterface
+{
+private:
+    LexerInterface& lexer;
+    std::ostream& out;
+
+public:
+    DumpingLexer(LexerInterface& _lexer, std::ostream& _out);
+    void open(std::istream& _stream) override;
+    void open(const std::string& _path) override;
+    std::shared_ptr<const SourceFile> getSource() const override;
+    void setState(LexerStateInterface* _state) override;
+    Token getToken() override;
+    void print_all_tokens() override;
+};
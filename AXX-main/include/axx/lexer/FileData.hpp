@@ -1,18 +1,40 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <stack>
 #include <string>
-#include <queue>
 #include <axx/token/Token.hpp>
+#include <axx/token/TokenRing.hpp>
+#include <axx/lexer/InputBuffer.hpp>
 
-typedef std::queue<Token> tokenQueue_t;
+// За один символ автомат выдаёт не больше трёх токенов: число, точку и конец файла
+typedef TokenRing<8> tokenQueue_t;
 
 struct FileData
 {
-    unsigned int pos = 1;
-    unsigned int row = 1;
     std::string accum;
     tokenQueue_t queue;
+    // Для отображённого файла лексема хранится смещением begin и длиной length внутри source,
+    // в accum она копируется, только если перестаёт совпадать с участком файла.
+    // Токен такой лексемы ссылается на файл через его номер sourceId в TextStorage
+    const char* source = nullptr;
+    std::uint16_t sourceId = 0;
+    std::size_t sourceSize = 0;
+    const char* cursor = nullptr;
+    std::size_t begin = 0;
+    std::size_t length = 0;
+    // Место токена - смещение символа от начала текста, строки и позиции считает таблица lines
+    const InputBuffer* input = nullptr;
+    std::uint16_t lines = 0;
+    std::uint32_t offset(const char* _p) const
+    {
+        return input->offset(_p);
+    }
     Token get();
-    void put(Type _type, unsigned int _row = 0, unsigned int _pos = 0);
+    void push(char _c);
+    /// @brief Дописывает _count символов, начиная с _begin; cursor при этом не нужен
+    void push(const char* _begin, std::size_t _count);
+    void put(Type _type, std::uint32_t _place);
+    void discard();
     FileData();
 };
@@ -0,0 +1,43 @@
+#pragma once
+#include <axx/token/SourceFile.hpp>
+#include <axx/token/LineIndex.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+
+/// @brief Входные данные лексера: поток, читаемый порциями по CHARCOUNT символов, или отображённый в память файл
+class InputBuffer
+{
+private:
+    std::istream* stream = nullptr;
+    std::unique_ptr<std::string> currBuff;
+    std::unique_ptr<std::string> otherBuff;
+    std::shared_ptr<const SourceFile> source;
+    std::unique_ptr<LineIndex> streamLines;
+    const char* origin = nullptr; // Символ со смещением base от начала текста
+    std::uint32_t base = 0;
+    std::uint32_t filled = 0; // Сколько символов текущей порции прочитано из потока
+
+    bool read();
+public:
+    const char* iter = nullptr;
+    const char* end = nullptr;
+
+    void open(std::istream& _stream);
+    void open(std::shared_ptr<const SourceFile> _source);
+    /// @brief Открывает участок [_begin, _end) отображённого файла
+    void open(std::shared_ptr<const SourceFile> _source, std::size_t _begin, std::size_t _end);
+    /// @brief Читает следующую порцию потока; false, если текст закончился
+    bool refill();
+    bool isMapped() const;
+    std::shared_ptr<const SourceFile> getSource() const;
+    /// @brief Номер таблицы строк читаемого текста
+    std::uint16_t getLines() const;
+    /// @brief Смещение символа текущей порции от начала текста
+    std::uint32_t offset(const char* _p) const
+    {
+        return base + static_cast<std::uint32_t>(_p - origin);
+    }
+};
@@ -0,0 +1,6 @@
+#pragma once
+#include <axx/token/Token.hpp>
+#include <string_view>
+
+/// @brief Возвращает тип ключевого слова или Type::id, если _id не является ключевым словом
+Type recognize_keyword(std::string_view _id);
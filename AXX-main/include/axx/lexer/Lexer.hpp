@@ -1,23 +1,28 @@
 #pragma once
 #include <axx/interface/LexerInterface.hpp>
 #include <axx/token/Token.hpp>
+#include <axx/token/Interner.hpp>
 #include <axx/lexer/FileData.hpp>
+#include <axx/lexer/InputBuffer.hpp>
 #include <memory>
 #include <queue>
 
 class Lexer: public LexerInterface
 {
 private:
-    std::istream* stream;
-    std::unique_ptr<std::string> currBuff;
-    std::unique_ptr<std::string> otherBuff;
+    InputBuffer input;
     std::unique_ptr<LexerStateInterface> state;
-    std::string::const_iterator iter;
     std::unique_ptr<FileData> filedata;
+    Interner& interner;
 
-    Type recognize(const std::string& _id) const;
+    void scan();
+    void finish();
+    Token next();
 public:
+    Lexer(Interner& _interner);
     void open(std::istream& _stream) override;
+    void open(const std::string& _path) override;
+    std::shared_ptr<const SourceFile> getSource() const override;
     void setState(LexerStateInterface* _state) override;
     Token getToken() override;
     void print_all_tokens() override;
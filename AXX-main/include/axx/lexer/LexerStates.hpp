@@ -20,7 +20,7 @@ class BaseLexerState : public LexerStateInterface
 protected:
     LexerInterface *lexer;
     FileData *filedata;
-    unsigned int initpos;
+    std::uint32_t initpos; // Смещение начала лексемы от начала текста
     Type type;
     BaseLexerState(LexerInterface *_lex, FileData *_filedata);
 };
@@ -32,10 +32,26 @@ private:
 public:
     Id(LexerInterface *_lex, FileData *_filedata);
     bool recognize(char _c);
+    const char* fastforward(const char* _begin, const char* _end) override;
+};
+
+class Skip : public BaseLexerState
+{
+public:
+    Skip(LexerInterface *_lex, FileData *_filedata);
+    bool recognize(char _c);
+    const char* fastforward(const char* _begin, const char* _end) override;
+};
+
+class Comment : public BaseLexerState
+{
+public:
+    Comment(LexerInterface *_lex, FileData *_filedata);
+    bool recognize(char _c);
+    const char* fastforward(const char* _begin, const char* _end) override;
 };
 
 st(Start)
-st(Skip)
 st(FirstNumPart)
 st(String)
 st(Character)
@@ -55,16 +71,14 @@ st(Inv)
 st(Band)
 st(Lpr)
 st(Rpr)
-st(Comment)
 st(Comma)
-st(Newline)
 
 class SecondNumPart : public BaseLexerState
 {
 private:
     bool created = true;
 public:
-    SecondNumPart(LexerInterface *_lex, FileData *_filedata, unsigned int _initpos);
+    SecondNumPart(LexerInterface *_lex, FileData *_filedata, std::uint32_t _initpos);
     bool recognize(char _c);
 };
 
@@ -0,0 +1,33 @@
+#pragma once
+#include <axx/interface/LexerInterface.hpp>
+#include <axx/token/Token.hpp>
+#include <axx/token/Interner.hpp>
+#include <axx/lexer/TableLexer.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/// @brief Лексер, разбирающий большой отображённый файл в несколько потоков.
+/// Файл делится на участки по переводам строк вне строковых и символьных литералов, каждый участок
+/// разбирается своим TableLexer, а токены сшиваются по порядку. Идентификаторы заносятся в Interner
+/// при выдаче, поэтому номера и канонические написания те же, что у последовательного лексера
+class ParallelLexer : public LexerInterface
+{
+private:
+    Interner& interner;
+    unsigned int threads;
+    std::shared_ptr<const SourceFile> source;
+    std::unique_ptr<TableLexer> sequential; // Поток и небольшой файл на участки не делятся и читаются последовательно
+    std::vector<Token> tokens;
+    std::size_t current;
+
+public:
+    /// @brief _threads = 0 - по числу аппаратных потоков
+    ParallelLexer(Interner& _interner, unsigned int _threads = 0);
+    void open(std::istream& _stream) override;
+    void open(const std::string& _path) override;
+    std::shared_ptr<const SourceFile> getSource() const override;
+    void setState(LexerStateInterface* _state) override;
+    Token getToken() override;
+    void print_all_tokens() override;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+// Ядра для длинных однородных участков текста. Участок просматривается по 32 (AVX2) или 16 (SSE2) байт,
+// набор инструкций выбирается при запуске, на остальных процессорах работает посимвольный вариант
+
+/// @brief Конец серии пробелов, табуляций и возвратов каретки, начинающейся с _begin
+const char* skip_blanks(const char* _begin, const char* _end);
+
+/// @brief Первый '\n' в [_begin, _end) или _end, если его нет
+const char* find_newline(const char* _begin, const char* _end);
+
+/// @brief Конец серии латинских букв и цифр, начинающейся с _begin. Подчёркивание серию
+/// прерывает, чтобы лексер сам проверил, что за ним не идёт второе
+const char* skip_alnum(const char* _begin, const char* _end);
@@ -0,0 +1,43 @@
+#pragma once
+#include <axx/interface/LexerInterface.hpp>
+#include <axx/token/Token.hpp>
+#include <axx/token/Interner.hpp>
+#include <axx/lexer/FileData.hpp>
+#include <axx/lexer/InputBuffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// @brief Лексер на плоской таблице переходов (состояние, класс символа).
+/// Выдаёт ту же последовательность токенов, что и Lexer, но не создаёт объект состояния на каждый символ
+class TableLexer : public LexerInterface
+{
+private:
+    InputBuffer input;
+    std::unique_ptr<FileData> filedata;
+    Interner& interner;
+    std::uint8_t current;
+    std::uint32_t initpos; // Смещение начала лексемы от начала текста
+
+    void step(char _c);
+    void fastforward();
+    void scan();
+    void finish();
+    Token next();
+    Token read();
+public:
+    TableLexer(Interner& _interner);
+    void open(std::istream& _stream) override;
+    void open(const std::string& _path) override;
+    /// @brief Открывает участок [_begin, _end) отображённого файла. Участок не с начала файла должен начинаться
+    /// с перевода строки вне строковых и символьных литералов
+    void open(std::shared_ptr<const SourceFile> _source, std::size_t _begin, std::size_t _end);
+    std::shared_ptr<const SourceFile> getSource() const override;
+    void setState(LexerStateInterface* _state) override;
+    Token getToken() override;
+    void print_all_tokens() override;
+    /// @brief Дописывает в _tokens все оставшиеся токены вместе с конечным eof.
+    /// Идентификаторы в Interner не заносятся, это делает вызывающий
+    void tokenize(std::vector<Token>& _tokens);
+};
@@ -0,0 +1,16 @@
+#pragma once
+#include <axx/interface/OptimizerInterface.hpp>
+#include <axx/token/Interner.hpp>
+
+/// @brief Вычисляет статические выражения: подвыражения из литералов Integer, Float и Bool
+/// заменяются листьями-константами. Запускается после семантического анализа, так что типы
+/// операндов уже согласованы
+class ConstantFolder : public OptimizerInterface
+{
+private:
+    Interner& interner;
+
+public:
+    ConstantFolder(Interner& _interner);
+    void optimize(AST *_ast) override;
+};
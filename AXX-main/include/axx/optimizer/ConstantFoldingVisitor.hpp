@@ -0,0 +1,65 @@
+#pragma once
+#include <axx/interface/NodeVisitorInterface.hpp>
+#include <axx/AST/ASTArena.hpp>
+#include <axx/token/Interner.hpp>
+#include <cstdint>
+
+/// @brief Обходит дерево и заменяет выражения на их значения. Для каждого выражения fold
+/// возвращает узел, которым его нужно заменить (или его самого)
+class ConstantFoldingVisitor : public NodeVisitorInterface
+{
+private:
+    /// @brief Значение выражения, известное при трансляции
+    struct Constant
+    {
+        enum Kind : std::uint8_t
+        {
+            NONE, // Значение не известно
+            INTEGER,
+            FLOAT,
+            BOOL,
+        } kind;
+        std::int64_t integer;
+        float real; // Float в Ada - число одинарной точности
+        bool boolean;
+    };
+
+    ASTArena& arena;
+    Interner& interner;
+    symbol_t true_symbol;
+    symbol_t false_symbol;
+
+    // Результат последнего посещённого выражения
+    ExpressionNode* folded;
+    Constant constant;
+    bool pure; // В выражении нет вызовов, его можно выбросить, не меняя поведения программы
+
+    Constant literal(const Token& _token);
+    Leaf* make(const Constant& _value);
+    bool binary(Type _op, const Constant& _left, const Constant& _right, Constant& _result);
+    void fold(BaseASTNode*& _node);
+
+public:
+    ConstantFoldingVisitor(ASTArena& _arena, Interner& _interner);
+    /// @brief Упрощает выражение _expression и возвращает узел, которым его нужно заменить
+    ExpressionNode* fold(ExpressionNode* _expression);
+
+    void visitLeaf(Leaf *_acceptor);
+    void visitFormalParamsNode(FormalParamsNode *_acceptor);
+    void visitActualParamsNode(ActualParamsNode *_acceptor);
+    void visitCallNode(CallNode *_acceptor);
+    void visitBinaryNode(BinaryNode *_acceptor);
+    void visitUnaryNode(UnaryNode *_acceptor);
+    void visitAssignmentNode(AssignmentNode *_acceptor);
+    void visitReturnNode(ReturnNode *_acceptor);
+    void visitBlockNode(BlockNode *_acceptor);
+    void visitProgramNode(ProgramNode *_acceptor);
+    void visitFunctionNode(FunctionNode *_acceptor);
+    void visitProcedureNode(ProcedureNode *_acceptor);
+    void visitElseNode(ElseNode *_acceptor);
+    void visitElifNode(ElifNode *_acceptor);
+    void visitIfNode(IfNode *_acceptor);
+    void visitWhileNode(WhileNode *_acceptor);
+    void visitForNode(ForNode *_acceptor);
+    void visitVarDeclNode(VariableDeclarationNode *_acceptor);
+};
@@ -2,19 +2,31 @@
 #include <axx/interface/ParserInterface.hpp>
 #include <axx/AST/ASTNode.hpp>
 #include <axx/AST/AST.hpp>
+#include <axx/AST/ASTArena.hpp>
+#include <axx/token/TokenRing.hpp>
+#include <axx/token/Diagnostics.hpp>
+#include <memory>
 #include <vector>
 
+enum class Rule : std::uint8_t;
+
 class Parser : public ParserInterface
 {
 private:
     LexerInterface* lexer;
     Token token;  // Текущий токен кода
-    std::vector<Token> future_tokens; // Сюда будут складываться токены при просмотре "наперёд" методом forward
+    TokenRing<4> future_tokens; // Сюда будут складываться токены при просмотре "наперёд" методом forward
+    std::unique_ptr<ASTArena> arena; // Память для узлов дерева, которое строится сейчас
+    bool finished; // Конец файла уже выдан getNextStatement
+    Diagnostics& diagnostics;
 
-    bool is_token_in_firsts(std::string grammar_node);
+    bool is_token_in_firsts(Rule grammar_node);
     bool token_matches_any(std::vector<Type> types);
     bool token_matches(Type type);
-    void error(std::string message);
+    void report(const char *context);
+    [[noreturn]] void error(const char *context);
+    void synchronize();
+    void skip_to_subprogram();
     void next_token();
     Token forward(int k);
     Token get_token();
@@ -39,13 +51,8 @@ private:
     AssignmentNode * assignment();
     ReturnNode * return_stmt();
     ExpressionNode * expression();
-    ExpressionNode * disjunction();
-    ExpressionNode * conjunction();
-    ExpressionNode * inversion();
-    ExpressionNode * comparison();
-    ExpressionNode * sum();
-    ExpressionNode * term();
-    ExpressionNode * factor();
+    ExpressionNode * binary_expression(int min_power);
+    ExpressionNode * unary_expression(int min_power);
     ExpressionNode * primary();
     ActualParamsNode * func_call();
     Leaf * atom();
@@ -56,5 +63,6 @@ private:
 public:
     void setLexer(LexerInterface*);
     AST* getAST();
-    Parser();
+    AST* getNextStatement();
+    Parser(Diagnostics& _diagnostics);
 };
\ No newline at end of file
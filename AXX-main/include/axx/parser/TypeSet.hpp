@@ -0,0 +1,30 @@
+#pragma once
+#include <axx/token/Token.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+/// @brief Множество типов токенов в виде битовой маски, проверка принадлежности - один битовый тест
+class TypeSet
+{
+private:
+    static constexpr std::size_t WORDS = (static_cast<std::size_t>(Type::unexpected) + 64) / 64;
+    std::uint64_t bits[WORDS] = {};
+
+public:
+    constexpr TypeSet() = default;
+    constexpr TypeSet(std::initializer_list<Type> _types)
+    {
+        for (Type type : _types)
+        {
+            auto index = static_cast<std::size_t>(type);
+            bits[index / 64] |= std::uint64_t(1) << (index % 64);
+        }
+    }
+
+    constexpr bool contains(Type _type) const
+    {
+        auto index = static_cast<std::size_t>(_type);
+        return (bits[index / 64] >> (index % 64)) & 1;
+    }
+};
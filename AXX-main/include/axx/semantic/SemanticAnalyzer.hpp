@@ -1,14 +1,22 @@
 #pragma once
 #include <axx/interface/SemanticAnalyzerInterface.hpp>
+#include <axx/semantic/SemanticGlobals.hpp>
 #include <axx/semantic/SemanticVisitor.hpp>
 #include <memory>
 
+/// @brief Проверка в две фазы: сначала в SemanticGlobals собираются сигнатуры всех подпрограмм,
+/// затем тела проверяются параллельно, каждое своим SemanticVisitor. Поэтому подпрограмму можно
+/// вызвать выше её объявления. Ошибки записываются в Diagnostics в порядке текста программы
 class SemanticAnalyzer : public SemanticAnalyzerInterface
 {
 private:
-    std::unique_ptr<SemanticVisitor> visitor;
+    Interner& interner;
+    Diagnostics& diagnostics;
+    std::unique_ptr<SemanticGlobals> globals; // Живёт между вызовами check в потоковом режиме
+    unsigned int threads;
 
 public:
-    SemanticAnalyzer();
+    /// @brief _threads = 0 - по числу ядер
+    SemanticAnalyzer(Interner& _interner, Diagnostics& _diagnostics, unsigned int _threads = 0);
     void check(AST *_tree) override;
 };
@@ -0,0 +1,30 @@
+#pragma once
+#include <axx/AST/ASTNodePublic.hpp>
+#include <axx/semantic/SymbolTable.hpp>
+#include <axx/token/Diagnostics.hpp>
+#include <axx/semantic/TypeTable.hpp>
+#include <axx/token/Interner.hpp>
+#include <map>
+#include <utility>
+#include <vector>
+
+/// @brief Глобальные имена программы: встроенные имена и сигнатуры всех подпрограмм.
+/// Заполняется первой фазой анализа, во второй фазе тела подпрограмм только читают её
+class SemanticGlobals
+{
+public:
+    typedef std::pair<type_t, std::vector<type_t>> func_pair_t; // Тип результата и типы параметров
+    typedef std::map<symbol_t, func_pair_t> func_map_t;
+
+    SymbolTable symbols;
+    TypeTable types; // Пополняется и во второй фазе, защищена своим мьютексом
+    func_map_t funcs;
+
+    SemanticGlobals(Interner& _interner);
+    /// @brief Регистрирует сигнатуру подпрограммы, _result - тип результата.
+    /// Повторное имя записывается в _diagnostics, и подпрограмма не регистрируется
+    bool declare(Leaf* _id, FormalParamsNode* _params, type_t _result, Diagnostics& _diagnostics);
+
+private:
+    Interner& interner;
+};
@@ -1,31 +1,32 @@
 #pragma once
 #include <axx/interface/NodeVisitorInterface.hpp>
 #include <axx/token/Token.hpp>
+#include <axx/token/Interner.hpp>
+#include <axx/token/Diagnostics.hpp>
 #include <axx/semantic/Symbol.hpp>
+#include <axx/semantic/SemanticGlobals.hpp>
+#include <axx/semantic/SymbolTable.hpp>
+#include <axx/semantic/TypeTable.hpp>
 
 #include <memory>
-#include <stack>
 #include <string>
-#include <utility>
-#include <map>
 #include <vector>
 
+/// @brief Проверяет одну подпрограмму верхнего уровня. Сигнатуры всех подпрограмм уже лежат
+/// в SemanticGlobals, локальные имена - в собственной таблице, так что посетители разных
+/// подпрограмм можно запускать одновременно
 class SemanticVisitor : public NodeVisitorInterface
 {
 private:
-    typedef std::map<std::string, Symbol> localtable_t;
-    typedef std::set<std::string> typeset_t;
-    typedef typeset_t::const_iterator type_t;
-    typedef std::pair<type_t, std::vector<type_t>> func_pair_t;
-    typedef std::map<std::string, func_pair_t> func_map_t;
-
-    std::stack<std::unique_ptr<localtable_t>> symtable;
-    typeset_t set;
-    func_map_t funcs;
+    SymbolTable symtable;
+    TypeTable& types;
+    const SemanticGlobals::func_map_t& funcs;
     type_t evaluated_type;
-    unsigned int lastpos;
-    unsigned int lastrow;
+    Token last; // Последнее имя в выражении, к нему привязываются ошибки типов
+    Interner& interner;
+    Diagnostics& diagnostics;
 public:
+    SemanticVisitor(SemanticGlobals& _globals, Interner& _interner, Diagnostics& _diagnostics);
     void visitLeaf(Leaf *_acceptor);
     void visitFormalParamsNode(FormalParamsNode *_acceptor);
     void visitActualParamsNode(ActualParamsNode *_acceptor);
@@ -45,5 +46,7 @@ public:
     void visitForNode(ForNode *_acceptor);
     void visitVarDeclNode(VariableDeclarationNode *_acceptor);
 
-    void stdinit();
+private:
+    static bool compatible(type_t _left, type_t _right);
+    void subprogram(FormalParamsNode *_params, std::vector<VariableDeclarationNode *>& _declarations, BlockNode *_body);
 };
@@ -1,10 +1,12 @@
 #pragma once
 #include <axx/token/Token.hpp>
-#include <set>
+#include <axx/token/Interner.hpp>
+#include <axx/semantic/TypeTable.hpp>
 
 struct Symbol
 {
     Token token;
-    std::set<std::string>::const_iterator type;
-    Symbol(Token _token, std::set<std::string>::const_iterator _type);
+    type_t type;
+    bool parameter; // Параметр режима in: в Ada ему нельзя присваивать
+    Symbol(Token _token, type_t _type, bool _parameter = false);
 };
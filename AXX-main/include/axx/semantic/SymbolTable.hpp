@@ -0,0 +1,44 @@
+#pragma once
+#include <axx/semantic/Symbol.hpp>
+#include <axx/token/Interner.hpp>
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// @brief Таблица символов с вложенными областями видимости. Все видимые имена лежат в одной
+/// хеш-таблице, а журнал хранит, что было под именем до изменения во внутренней области.
+/// Вход в область стоит O(1), выход - число имён, объявленных или изменённых в ней.
+/// Имена, не найденные в таблице, ищутся в родительской таблице, которая при этом не меняется
+class SymbolTable
+{
+private:
+    struct Binding
+    {
+        Symbol symbol;
+        std::size_t depth; // Глубина области, которой принадлежит запись
+    };
+
+    std::unordered_map<symbol_t, Binding> bindings;
+    std::vector<std::pair<symbol_t, std::optional<Binding>>> journal;
+    std::vector<std::size_t> scopes; // Размер журнала при входе в каждую открытую область
+    const SymbolTable* parent;
+
+    void remember(symbol_t _name, std::optional<Binding> _previous);
+
+public:
+    SymbolTable(const SymbolTable* _parent = nullptr);
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    void enter();
+    void leave();
+
+    /// @brief Ближайшее объявление имени или nullptr
+    const Symbol* find(symbol_t _name) const;
+    /// @brief Объявляет имя во внутренней области, если оно ещё не видно; возвращает, было ли оно добавлено
+    bool insert(symbol_t _name, const Symbol& _symbol);
+    /// @brief Символ для изменения: изменение видно только до выхода из текущей области
+    Symbol& modify(symbol_t _name);
+};
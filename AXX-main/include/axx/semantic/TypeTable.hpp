@@ -0,0 +1,59 @@
+#pragma once
+#include <axx/token/Interner.hpp>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// @brief Номер типа в TypeTable; равные номера - равные типы
+typedef std::uint32_t type_t;
+
+/// @brief Таблица типов. Каждый тип описан один раз: именованный тип находится по номеру
+/// идентификатора, массив - по номеру типа элементов и размеру. Встроенные типы имеют постоянные
+/// номера, так что проверка типа - сравнение чисел, и при проверке не строится ни одной строки.
+/// Таблица общая для потоков, проверяющих подпрограммы, и защищена мьютексом
+class TypeTable
+{
+public:
+    enum Kind : std::uint8_t
+    {
+        Named, // Тип или подпрограмма, заданные именем
+        Array,
+    };
+
+    struct Descriptor
+    {
+        Kind kind;
+        symbol_t name;   // Для Named
+        type_t element;  // Для Array
+        std::uint32_t size;
+    };
+
+    static constexpr type_t VOID = 0;
+    static constexpr type_t BOOL = 1;
+    static constexpr type_t INTEGER = 2;
+    static constexpr type_t FLOAT = 3;
+    static constexpr type_t STRING = 4;
+    static constexpr type_t NOTYPE = 0xFFFFFFFFu;
+    // Тип выражения, в котором уже найдена ошибка: совместим с любым типом, чтобы одна ошибка
+    // не порождала новых. В таблице не хранится, describe для него вызывать нельзя
+    static constexpr type_t POISON = 0xFFFFFFFEu;
+
+private:
+    std::vector<Descriptor> descriptors;
+    std::unordered_map<symbol_t, type_t> names;
+    std::unordered_map<std::uint64_t, type_t> arrays;
+    mutable std::mutex mutex;
+
+public:
+    TypeTable(Interner& _interner);
+
+    /// @brief Именованный тип; второе значение - был ли он создан этим вызовом
+    std::pair<type_t, bool> named(symbol_t _name);
+    /// @brief Именованный тип или NOTYPE, если такого имени ещё не было
+    type_t find(symbol_t _name) const;
+    /// @brief Массив из _size элементов типа _element
+    type_t array(type_t _element, std::uint32_t _size);
+    Descriptor describe(type_t _type) const;
+};
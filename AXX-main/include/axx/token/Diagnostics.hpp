@@ -0,0 +1,67 @@
+#pragma once
+#include <axx/token/Token.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum class Severity : std::uint8_t
+{
+    Error,
+    Warning,
+};
+
+/// @brief Вид сообщения, по нему выбирается текст при выводе
+enum class Problem : std::uint8_t
+{
+    Syntax,            // Парсер не ожидал токен, context - правило грамматики
+    Undefined,         // Имя не объявлено
+    AlreadyDefined,    // Имя объявлено повторно
+    AssignToParameter, // Присваивание параметру режима in
+    NotCallable,       // Вызывается не подпрограмма
+    ParameterCount,    // Число аргументов не совпадает с числом параметров
+    ParameterType,     // Тип аргумента не совпадает с типом параметра
+    TypeMismatch,      // Типы операндов или присваивания не совпадают
+    ConditionNotBool,  // Условие не логического типа
+};
+
+/// @brief Сообщение хранит только токены: текст собирается в render. Токены ссылаются на
+/// исходный файл и Interner, поэтому выводить сообщения нужно, пока они живы
+struct Diagnostic
+{
+    Severity severity;
+    Problem problem;
+    Token token;         // Токен, о котором сообщение: имя или неожиданный токен
+    Token at;            // Место ошибки, может отличаться от token (например, последний операнд выражения)
+    const char *context; // Правило грамматики для синтаксической ошибки, строковая константа
+
+    std::string render() const;
+};
+
+/// @brief Накопитель сообщений этапов трансляции. Этапы не останавливаются на первой ошибке,
+/// а записывают её и продолжают разбор, так что за один запуск выводятся все ошибки
+class Diagnostics
+{
+private:
+    std::vector<Diagnostic> entries;
+    std::size_t errors;
+
+public:
+    Diagnostics();
+    void report(const Diagnostic& _diagnostic);
+    /// @brief Ошибка вида _problem у токена _token
+    void error(Problem _problem, const Token& _token);
+    /// @brief Ошибка о токене _token, случившаяся в месте _at
+    void error(Problem _problem, const Token& _token, const Token& _at);
+    /// @brief Дописывает сообщения _other после своих
+    void append(const Diagnostics& _other);
+
+    std::size_t errorCount() const;
+    const std::vector<Diagnostic>& all() const;
+    /// @brief Сообщения в порядке места в тексте: синтаксические и семантические ошибки
+    /// записываются разными этапами, но выводятся одним упорядоченным списком
+    std::vector<Diagnostic> ordered() const;
+    /// @brief Выводит все сообщения по одному на строку в порядке ordered
+    void print(std::ostream& _stream) const;
+};
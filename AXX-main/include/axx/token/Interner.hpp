@@ -0,0 +1,41 @@
+#pragma once
+#include <axx/token/Token.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+typedef std::uint32_t symbol_t;
+
+/// @brief Таблица идентификаторов сеанса трансляции: каждому написанию идентификатора
+/// сопоставляется плотный 32-битный номер. Написания сравниваются без учёта регистра, как в Ada,
+/// каноническим считается первое встреченное
+class Interner
+{
+private:
+    std::uint16_t area; // Номер таблицы в TextStorage: по нему токен находит своё написание
+    // Написания лежат в участках удваивающегося размера, которые не перемещаются при росте
+    // таблицы: spelling() читает их без блокировки, пока intern() добавляет новые
+    std::unique_ptr<std::string_view[]> chunks[23];
+    symbol_t count;
+    std::vector<std::uint32_t> hashes;
+    std::vector<symbol_t> slots; // Открытая адресация: номер + 1, 0 - пустая ячейка
+    std::mutex mutex;
+
+    void grow();
+public:
+    Interner();
+    ~Interner();
+    Interner(const Interner&) = delete;
+    Interner& operator=(const Interner&) = delete;
+
+    symbol_t intern(std::string_view _spelling);
+    /// @brief Номер идентификатора в токене; токен не из этой таблицы добавляется в неё
+    symbol_t symbol(const Token& _token);
+    /// @brief Токен с текстом из таблицы
+    Token token(std::string_view _spelling, Type _type = Type::id);
+    void attach(Token& _token);
+    std::string_view spelling(symbol_t _symbol) const;
+    std::uint16_t getArea() const;
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/// @brief Таблица начал строк исходного текста. Токен хранит номер таблицы и смещение от начала текста,
+/// строка и позиция находятся двоичным поиском только тогда, когда понадобились.
+/// Таблица отображённого файла строится при первом запросе, таблица потока пополняется по мере чтения
+class LineIndex
+{
+private:
+    const char* data;
+    std::size_t size;
+    mutable std::vector<std::uint32_t> starts;
+    mutable std::once_flag built;
+    std::uint16_t id; // Номер таблицы, который хранит токен; 0 - координат нет. Освобождается с таблицей
+
+    void build() const;
+public:
+    /// @brief Таблица текста, доступного целиком
+    LineIndex(const char* _data, std::size_t _size);
+    /// @brief Таблица потока, заполняется через feed
+    LineIndex();
+    ~LineIndex();
+    LineIndex(const LineIndex&) = delete;
+    LineIndex& operator=(const LineIndex&) = delete;
+
+    /// @brief Добавляет переводы строк из очередной порции потока, _offset - смещение её начала
+    void feed(const char* _begin, std::size_t _count, std::uint32_t _offset);
+    /// @brief Строка и позиция (обе с 1) символа со смещением _offset
+    void resolve(std::uint32_t _offset, unsigned int& _row, unsigned int& _pos) const;
+    std::uint16_t getId() const;
+
+    static const LineIndex* find(std::uint16_t _id);
+    /// @brief Поколение номера таблицы: растёт при каждом его освобождении
+    static std::uint16_t generation(std::uint16_t _id);
+};
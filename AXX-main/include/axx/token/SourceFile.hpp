@@ -0,0 +1,31 @@
+#pragma once
+#include <axx/token/LineIndex.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/// @brief Исходный файл, целиком отображённый в память только для чтения
+class SourceFile
+{
+private:
+    const char* data;
+    std::size_t size;
+    std::uint16_t id; // Номер области в TextStorage
+    std::unique_ptr<LineIndex> lines;
+#ifdef _WIN32
+    void* file;
+    void* mapping;
+#endif
+
+public:
+    SourceFile(const std::string& _path);
+    ~SourceFile();
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+
+    const char* getData() const;
+    std::size_t getSize() const;
+    std::uint16_t getId() const;
+    const LineIndex& getLines() const;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+class Interner;
+
+/// @brief Общее хранилище текста токенов.
+/// Токен хранит номер области и смещение в ней: область - это отображённый исходный файл,
+/// блок памяти для текста, которого нет в исходнике (литералы из кода, лексемы при чтении из потока),
+/// или таблица идентификаторов, где смещение - номер идентификатора.
+/// Блоки текста принадлежат сеансу трансляции - живой таблице Interner - и освобождаются вместе с ней
+class TextStorage
+{
+public:
+    /// @brief Регистрирует область, возвращает её номер. Номер 0 означает пустой текст
+    static std::uint16_t attach(const char* _base);
+    static std::uint16_t attach(const Interner* _symbols);
+    /// @brief Освобождает номер области; у таблицы идентификаторов - и блоки её сеанса
+    static void detach(std::uint16_t _source);
+    /// @brief Копирует текст в хранилище, записывает номер области и смещение.
+    /// _owner - номер таблицы Interner, которой принадлежит текст; 0 - последней созданной
+    static void store(std::string_view _text, std::uint16_t& _source, std::uint32_t& _offset, std::uint16_t _owner = 0);
+    /// @brief Поколение номера области: растёт при каждом его освобождении. По нему токен замечает,
+    /// что номер его области уже освобождён и, возможно, отдан другому сеансу
+    static std::uint16_t generation(std::uint16_t _source);
+    static std::string_view view(std::uint16_t _source, std::uint32_t _offset, std::uint32_t _length);
+};
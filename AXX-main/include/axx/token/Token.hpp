@@ -1,8 +1,10 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 /// @brief Тип токена
-enum class Type
+enum class Type : std::uint8_t
 {
     id,         // Идентификатор
     number,     // Любое число, на последующих этапах трансляции будет распознано как целое или вещественное
@@ -112,21 +114,50 @@ enum class Type
 
 std::string type_to_str(Type type);
 
+class LineIndex;
+
+/// @brief Токен занимает 16 байт: текст не копируется, а берётся из TextStorage по номеру области и смещению.
+/// У идентификатора областью служит таблица Interner, а смещением - номер идентификатора.
+/// Место токена - смещение от начала файла; строка и позиция вычисляются по таблице строк LineIndex.
+/// Длина и тип делят одно слово, поэтому текст токена не длиннее MAXLENGTH символов.
+/// Номера областей освобождаются вместе с сеансами и используются снова, поэтому в отладочной сборке
+/// токен ещё помнит поколения своей области и таблицы строк и бросает std::logic_error, если пережил их
 class Token
 {
 private:
-    std::string value;
-    Type type;
-    unsigned int row;
-    unsigned int pos;
+    std::uint32_t offset;
+    std::uint32_t length : 24;
+    std::uint32_t type : 8;
+    std::uint32_t place;
+    std::uint16_t source;
+    std::uint16_t lines;
+#ifndef NDEBUG
+    std::uint16_t sourceGeneration;
+    std::uint16_t linesGeneration;
+#endif
 
+    static std::uint32_t checked(std::size_t _length);
+    void remember();
+    const LineIndex* lineIndex() const;
 public:
-    std::string getValue() const;
+    static constexpr std::uint32_t MAXLENGTH = (1u << 24) - 1;
+
+    std::string_view getValue() const;
     Type getType() const;
     unsigned int getPos() const;
     unsigned int getRow() const;
-    void setValue(std::string _value);
+    std::uint32_t getPlace() const;
+    std::uint16_t getSource() const;
+    std::uint32_t getSymbol() const;
+    void setValue(std::string_view _value);
+    void setSymbol(std::uint16_t _area, std::uint32_t _symbol, std::uint32_t _length);
     void setType(Type _type);
-    Token(std::string _value, Type _type, unsigned int _row = 0, unsigned int _pos = 0);
+    /// @brief _lines - номер таблицы строк LineIndex (0 - без координат), _place - смещение от начала файла
+    Token(std::string_view _value, Type _type, std::uint16_t _lines = 0, std::uint32_t _place = 0);
+    Token(Type _type, std::uint16_t _source, std::uint32_t _offset, std::uint32_t _length, std::uint16_t _lines = 0, std::uint32_t _place = 0);
     bool operator==(const Token& _other) const;
 };
+
+#ifdef NDEBUG
+static_assert(sizeof(Token) == 16, "Token must stay compact");
+#endif
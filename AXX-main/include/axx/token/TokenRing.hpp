@@ -0,0 +1,87 @@
+#pragma once
+#include <axx/token/Token.hpp>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/// @brief Кольцевой буфер токенов фиксированной ёмкости N. Память лежит внутри объекта,
+/// поэтому добавление, просмотр и извлечение не выделяют памяти и выполняются за O(1).
+/// Служит очередью готовых токенов лексера и буфером просмотра вперёд парсера
+template <std::size_t N>
+class TokenRing
+{
+    static_assert(N != 0 && (N & (N - 1)) == 0, "TokenRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<Token>::value && std::is_trivially_destructible<Token>::value,
+                  "TokenRing copies tokens as plain bytes");
+
+private:
+    alignas(Token) unsigned char storage[N * sizeof(Token)];
+    std::size_t head = 0;
+    std::size_t count = 0;
+
+    Token* slot(std::size_t _i)
+    {
+        return std::launder(reinterpret_cast<Token*>(storage)) + ((head + _i) & (N - 1));
+    }
+    const Token* slot(std::size_t _i) const
+    {
+        return std::launder(reinterpret_cast<const Token*>(storage)) + ((head + _i) & (N - 1));
+    }
+
+public:
+    TokenRing() = default;
+    TokenRing(const TokenRing&) = delete;
+    TokenRing& operator=(const TokenRing&) = delete;
+
+    template <typename... Args>
+    void emplace(Args&&... _args)
+    {
+        if (count == N)
+            throw std::length_error("Token ring is full");
+        new (slot(count)) Token(std::forward<Args>(_args)...);
+        count++;
+    }
+
+    void push(const Token& _token)
+    {
+        emplace(_token);
+    }
+
+    /// @brief Извлекает первый токен
+    Token pop()
+    {
+        Token tok = *slot(0);
+        head = (head + 1) & (N - 1);
+        count--;
+        return tok;
+    }
+
+    const Token& front() const
+    {
+        return *slot(0);
+    }
+
+    /// @brief Токен, стоящий _i-м после первого
+    const Token& peek(std::size_t _i) const
+    {
+        return *slot(_i);
+    }
+
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    void clear()
+    {
+        head = 0;
+        count = 0;
+    }
+};
@@ -2,10 +2,15 @@
 #include <fstream>
 #include <filesystem>
 #include <memory>
+#include <string>
 
 #include <axx/lexer/Lexer.hpp>
+#include <axx/lexer/TableLexer.hpp>
+#include <axx/lexer/ParallelLexer.hpp>
+#include <axx/lexer/DumpingLexer.hpp>
 #include <axx/parser/Parser.hpp>
 #include <axx/semantic/SemanticAnalyzer.hpp>
+#include <axx/optimizer/ConstantFolder.hpp>
 #include <axx/codegen/CodeGenerator.hpp>
 
 int main(int argc, char* argv[])
@@ -24,37 +29,147 @@ int main(int argc, char* argv[])
             return -1;
         }
 
-        std::ofstream output("output.cpp");
+        // Флаг --table-lexer включает табличный лексер вместо лексера на объектах состояний,
+        // флаг --parallel-lexer - табличный лексер, разбирающий файл по участкам в несколько потоков.
+        // Флаги --dump-tokens и --dump-ast выводят токены, прочитанные парсером, и построенное дерево.
+        // Флаг --streaming проверяет и выводит каждую инструкцию верхнего уровня сразу после разбора
+        // и освобождает её дерево, не строя дерево всего файла.
+        // Флаг --shards N вместо output.cpp выводит заголовок output.hpp с объявлениями подпрограмм
+        // и N файлов output_0.cpp ..., которые можно компилировать параллельно
+        bool table_lexer = false;
+        bool parallel_lexer = false;
+        bool dump_tokens = false;
+        bool dump_ast = false;
+        bool streaming = false;
+        unsigned long shards = 0;
+        for (int i = 2; i < argc; i++)
+        {
+            std::string flag(argv[i]);
+            if (flag == "--table-lexer")
+                table_lexer = true;
+            else if (flag == "--parallel-lexer")
+                parallel_lexer = true;
+            else if (flag == "--dump-tokens")
+                dump_tokens = true;
+            else if (flag == "--dump-ast")
+                dump_ast = true;
+            else if (flag == "--streaming")
+                streaming = true;
+            else if (flag == "--shards")
+            {
+                std::string count = i + 1 < argc ? argv[++i] : "";
+                if (count.empty() || count.find_first_not_of("0123456789") != count.npos ||
+                    count.size() > 4 || (shards = std::stoul(count)) == 0)
+                {
+                    std::cerr << "Option --shards expects a positive number of files\n";
+                    return -1;
+                }
+            }
+            else
+            {
+                std::cerr << "Unknown option " << flag << "\n";
+                return -1;
+            }
+        }
+
+        if (shards != 0 && streaming)
+        {
+            std::cerr << "Options --shards and --streaming cannot be combined\n";
+            return -1;
+        }
+
+        std::ofstream output;
+        if (shards == 0)
+            output.open("output.cpp");
 
-        auto lexer = std::make_unique<Lexer>();
-        auto parser = std::make_unique<Parser>();
-        auto seman = std::make_unique<SemanticAnalyzer>();
-        auto codegen = std::make_unique<CodeGenerator>(output);
+        // Таблица идентификаторов общая для всех этапов трансляции
+        Interner interner;
+        // Ошибки всех этапов копятся здесь и выводятся разом, код при ошибках не генерируется
+        Diagnostics diagnostics;
 
-        // Выводим все лексемы, полученные лексером
-        std::cout << "Lexer:\n";
-        std::ifstream file_lexer(argv[1]);
-        lexer->open(file_lexer);
-        lexer->print_all_tokens();
+        std::unique_ptr<LexerInterface> lexer;
+        if (parallel_lexer)
+            lexer = std::make_unique<ParallelLexer>(interner);
+        else if (table_lexer)
+            lexer = std::make_unique<TableLexer>(interner);
+        else
+            lexer = std::make_unique<Lexer>(interner);
+        auto parser = std::make_unique<Parser>(diagnostics);
+        auto seman = std::make_unique<SemanticAnalyzer>(interner, diagnostics);
+        auto optimizer = std::make_unique<ConstantFolder>(interner);
+        auto codegen = std::make_unique<CodeGenerator>(output, interner);
+
+        // Токены печатаются по мере того, как их забирает парсер: файл читается один раз
+        std::unique_ptr<LexerInterface> dumper;
+        LexerInterface* source = lexer.get();
+        if (dump_tokens)
+        {
+            dumper = std::make_unique<DumpingLexer>(*lexer, std::cout);
+            source = dumper.get();
+            std::cout << "Lexer:\n";
+        }
 
         try
         {
+            source->open(argv[1]);
+            parser->setLexer(source);
+            if (dump_ast)
+            {
+                std::cout << "\n\nParser:\n";
+            }
+
+            if (streaming)
+            {
+                codegen->start();
+                while (std::unique_ptr<AST> statement{parser->getNextStatement()})
+                {
+                    if (dump_ast)
+                    {
+                        statement->print();
+                    }
+                    seman->check(statement.get());
+                    if (diagnostics.errorCount() == 0)
+                    {
+                        optimizer->optimize(statement.get());
+                        codegen->generateStatement(statement.get());
+                    }
+                }
+                // Инструкции до первой ошибки уже выведены и остаются в output.cpp
+                codegen->finish();
+                if (diagnostics.errorCount() != 0)
+                {
+                    diagnostics.print(std::cerr);
+                    return -1;
+                }
+                return 0;
+            }
+
+            std::unique_ptr<AST> ast(parser->getAST());
 
             // Выводим дерево, полученное парсером
-            std::cout << "\n\nParser:\n";
-            std::ifstream file_parser(argv[1]);
-            lexer->open(file_parser);
-            parser->setLexer(lexer.get());
-            auto ast = parser->getAST();
-            ast->print();
+            if (dump_ast)
+            {
+                ast->print();
+            }
 
             // Проводим семантический анализ дерева
-            seman->check(ast);
+            seman->check(ast.get());
+            if (diagnostics.errorCount() != 0)
+            {
+                diagnostics.print(std::cerr);
+                exit(-1);
+            }
+
+            // Вычисляем статические выражения
+            optimizer->optimize(ast.get());
 
             // Генерация кода
-            codegen->generate(ast);
+            if (shards != 0)
+                codegen->generateShards(ast.get(), "output", shards);
+            else
+                codegen->generate(ast.get());
         }
-        catch (std::exception e)
+        catch (const std::exception& e)
         {
             std::cerr << e.what() << std::endl;
             exit(-1);
@@ -1,6 +1,7 @@
 #include <axx/AST/AST.hpp>
 
-AST::AST(BaseASTNode *root)
+AST::AST(BaseASTNode *root, std::shared_ptr<const SourceFile> source, std::unique_ptr<ASTArena> arena)
+    : source(std::move(source)), arena(std::move(arena))
 {
     this->root = root;
 }
@@ -10,6 +11,21 @@ void AST::print()
     this->root->print(0);
 }
 
+BaseASTNode *AST::getRoot()
+{
+    return root;
+}
+
+void AST::setRoot(BaseASTNode *_root)
+{
+    root = _root;
+}
+
+ASTArena *AST::getArena()
+{
+    return arena.get();
+}
+
 void AST::accept(NodeVisitorInterface *_visitor)
 {
     root->accept(_visitor);
@@ -0,0 +1,28 @@
+#include <axx/AST/ASTArena.hpp>
+#include <cstdint>
+
+#define BLOCKSIZE (64 * 1024)
+
+void* ASTArena::allocate(std::size_t _size, std::size_t _align)
+{
+    std::size_t padding = (_align - reinterpret_cast<std::uintptr_t>(cursor) % _align) % _align;
+    if (cursor == nullptr || padding + _size > left)
+    {
+        // Новый блок; узел крупнее блока получает блок своего размера
+        std::size_t size = _size + _align > BLOCKSIZE ? _size + _align : BLOCKSIZE;
+        blocks.emplace_back(new unsigned char[size]);
+        cursor = blocks.back().get();
+        left = size;
+        padding = (_align - reinterpret_cast<std::uintptr_t>(cursor) % _align) % _align;
+    }
+    void* result = cursor + padding;
+    cursor += padding + _size;
+    left -= padding + _size;
+    return result;
+}
+
+ASTArena::~ASTArena()
+{
+    for (auto it = destructors.rbegin(); it != destructors.rend(); ++it)
+        it->destroy(it->object);
+}
@@ -80,7 +80,7 @@ void print_indented_line(std::string text, int indent)
 
 void Leaf::print(int indent)
 {
-    std::string text = "<" + type_to_str(this->token.getType()) + ", " + this->token.getValue() + ">";
+    std::string text = "<" + type_to_str(this->token.getType()) + ", " + std::string(this->token.getValue()) + ">";
     print_indented_line(text, indent);
 }
 
@@ -115,7 +115,7 @@ void CallNode::print(int indent)
     std::string text = "Call";
     print_indented_line(text, indent);
     print_indented_line("callable:", indent + 1);
-    print_indented_line(this->callable.getValue(), indent + 2);
+    print_indented_line(std::string(this->callable.getValue()), indent + 2);
     print_indented_line("params:", indent + 1);
     this->params->print(indent + 2);
 }
@@ -267,9 +267,9 @@ void VariableDeclarationNode::print(int indent) {
     std::string text = "Variable Declaration";
     print_indented_line(text, indent);
     print_indented_line("name:", indent + 1);
-    print_indented_line(this->var_name.getValue(), indent + 2);
+    print_indented_line(std::string(this->var_name.getValue()), indent + 2);
     print_indented_line("type:", indent + 1);
-    print_indented_line(this->type->token.getValue(), indent + 2);
+    print_indented_line(std::string(this->type->token.getValue()), indent + 2);
     if (this->size != 0) {
         print_indented_line("size:", indent + 1);
         print_indented_line(std::to_string(this->size), indent + 2);
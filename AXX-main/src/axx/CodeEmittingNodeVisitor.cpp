@@ -1,22 +1,47 @@
 #include <axx/codegen/CodeEmittingNodeVisitor.hpp>
 #include <axx/AST/ASTNode.hpp>
-#include <map>
+#include <array>
+#include <string>
 
-CodeEmittingNodeVisitor::CodeEmittingNodeVisitor(std::ostream& _stream): 
-    stream(_stream), block_declarations({}){}
+// Запись операторов в C++, пустая строка - токен не является оператором
+constexpr std::array<std::string_view, static_cast<std::size_t>(Type::unexpected) + 1> make_operator_spellings()
+{
+    std::array<std::string_view, static_cast<std::size_t>(Type::unexpected) + 1> spellings = {};
+    spellings[static_cast<std::size_t>(Type::orop)] = "||";
+    spellings[static_cast<std::size_t>(Type::andop)] = "&&";
+    spellings[static_cast<std::size_t>(Type::notop)] = "!";
+    spellings[static_cast<std::size_t>(Type::plus)] = "+";
+    spellings[static_cast<std::size_t>(Type::minus)] = "-";
+    spellings[static_cast<std::size_t>(Type::star)] = "*";
+    spellings[static_cast<std::size_t>(Type::div)] = "/";
+    spellings[static_cast<std::size_t>(Type::greater)] = ">";
+    spellings[static_cast<std::size_t>(Type::less)] = "<";
+    spellings[static_cast<std::size_t>(Type::equal)] = "==";
+    spellings[static_cast<std::size_t>(Type::noteq)] = "!=";
+    spellings[static_cast<std::size_t>(Type::grequal)] = ">=";
+    spellings[static_cast<std::size_t>(Type::lequal)] = "<=";
+    return spellings;
+}
 
-void CodeEmittingNodeVisitor::write(std::string s) {
-    std::map<std::string, std::string> reserved = {
-        {"Integer", "int"},
-        {"String", "std::string"}, 
-        {"integer", "int"},
-        {"string", "std::string"}, 
-    };
-    if (reserved.find(s) != reserved.end()) {
-        this->stream << reserved.at(s);
-    } else {
-        this->stream << s;
+constexpr auto OPERATOR_SPELLING = make_operator_spellings();
+
+CodeEmittingNodeVisitor::CodeEmittingNodeVisitor(OutputBuffer& _output, Interner& _interner):
+    output(_output), interner(_interner), features(0), block_declarations({})
+{
+    // Имена сравниваются без учёта регистра, так что integer и string совпадут с Integer и String
+    for (auto name : {std::pair<std::string_view, std::string_view>{"Integer", "int"}, {"String", "std::string"}})
+    {
+        symbol_t symbol = interner.intern(name.first);
+        if (reserved.size() <= symbol)
+            reserved.resize(symbol + 1);
+        reserved[symbol] = name.second;
     }
+    string_type = interner.intern("String");
+    put_line = interner.intern("Put_Line");
+}
+
+void CodeEmittingNodeVisitor::write(std::string_view s) {
+    this->output.append(s);
 }
 
 void CodeEmittingNodeVisitor::write(Token token) {
@@ -24,6 +49,15 @@ void CodeEmittingNodeVisitor::write(Token token) {
         write("\"");
         write(token.getValue());
         write("\"");
+    } else if (token.getType() == Type::id) {
+        symbol_t symbol = interner.symbol(token);
+        if (symbol < reserved.size() && !reserved[symbol].empty()) {
+            if (symbol == string_type)
+                features |= STRINGS;
+            write(reserved[symbol]);
+        } else {
+            write(token.getValue());
+        }
     } else {
         write(token.getValue());
     }
@@ -40,10 +74,15 @@ void CodeEmittingNodeVisitor::visitLeaf(Leaf *_acceptor)
 
 void CodeEmittingNodeVisitor::visitFormalParamsNode(FormalParamsNode *_acceptor)
 {
+    // Параметры Ada без режима - in, то есть только для чтения: составные типы передаются
+    // по константной ссылке, чтобы не копировать их при каждом вызове, скалярные - по значению
     int count = _acceptor->names.size();
     for (int i = 0; i < count; i++) {
+        bool composite = interner.symbol(_acceptor->types[i]->token) == string_type;
+        if (composite)
+            write("const ");
         write(_acceptor->types[i]);
-        write(" ");
+        write(composite ? " &" : " ");
         write(_acceptor->names[i]);
         if (i != (count - 1))
             write(", ");
@@ -60,6 +99,8 @@ void CodeEmittingNodeVisitor::visitActualParamsNode(ActualParamsNode *_acceptor)
 }
 void CodeEmittingNodeVisitor::visitCallNode(CallNode *_acceptor)
 {
+    if (interner.symbol(_acceptor->callable) == put_line)
+        features |= OUTPUT;
     write(_acceptor->callable);
     write("(");
     _acceptor->params->accept(this);
@@ -67,40 +108,37 @@ void CodeEmittingNodeVisitor::visitCallNode(CallNode *_acceptor)
 }
 void CodeEmittingNodeVisitor::visitBinaryNode(BinaryNode *_acceptor)
 {
-    std::map<Type, std::string> bin_op_strs = {
-        {Type::orop, "||"},
-        {Type::andop, "&&"},
-        {Type::plus, "+"},
-        {Type::minus, "-"},
-        {Type::star, "*"},
-        {Type::div, "/"},
-        {Type::greater, ">"},
-        {Type::less, "<"},
-        {Type::equal, "=="},
-        {Type::noteq, "!="},
-        {Type::grequal, ">="},
-        {Type::lequal, "<="},
-        {Type::mod, "%"},
-    };
     Type op = _acceptor->op->token.getType();
+    if (op == Type::mod) {
+        // Результат тот же, что у ConstantFoldingVisitor при вычислении mod
+        features |= MODULO;
+        write("axx_rt::mod(");
+        _acceptor->left->accept(this);
+        write(", ");
+        _acceptor->right->accept(this);
+        write(")");
+        return;
+    }
     write("(");
     _acceptor->left->accept(this);
     write(" ");
-    write(bin_op_strs.at(op));
+    write(OPERATOR_SPELLING[static_cast<std::size_t>(op)]);
     write(" ");
     _acceptor->right->accept(this);
     write(")");
 }
 void CodeEmittingNodeVisitor::visitUnaryNode(UnaryNode *_acceptor)
 {
-    std::map<Type, std::string> bin_op_strs = {
-        {Type::notop, "!"},
-        {Type::plus, "+"},
-        {Type::minus, "-"}
-    };
     Type op = _acceptor->op->token.getType();
-    write(bin_op_strs.at(op));
+    write(OPERATOR_SPELLING[static_cast<std::size_t>(op)]);
+    // Без скобок -(-x) и минус перед отрицательной константой после свёртки дали бы -- в C++
+    auto leaf = dynamic_cast<Leaf *>(_acceptor->operand);
+    bool nested = dynamic_cast<UnaryNode *>(_acceptor->operand) || (leaf && leaf->token.getValue().substr(0, 1) == "-");
+    if (nested)
+        write("(");
     _acceptor->operand->accept(this);
+    if (nested)
+        write(")");
 }
 void CodeEmittingNodeVisitor::visitAssignmentNode(AssignmentNode *_acceptor)
 {
@@ -124,31 +162,66 @@ void CodeEmittingNodeVisitor::visitBlockNode(BlockNode *_acceptor)
 }
 void CodeEmittingNodeVisitor::visitProgramNode(ProgramNode *_acceptor)
 {
-    write("#include <bits/stdc++.h>\n");
     for (auto child: _acceptor->children) {
-        child->accept(this);
-        write(";\n");
+        statement(child);
     }
 }
-void CodeEmittingNodeVisitor::visitFunctionNode(FunctionNode *_acceptor)
+void CodeEmittingNodeVisitor::prologue(unsigned int _features)
+{
+    // Put_Line принимает std::string
+    if (_features & (STRINGS | OUTPUT))
+        write("#include <string>\n");
+    if (_features & OUTPUT) {
+        write("#include <iostream>\n");
+        write("inline void Put_Line(const std::string &s) { std::cout << s << '\\n'; }\n");
+    }
+    // mod - ключевое слово Ada, поэтому axx_rt::mod не совпадёт ни с одной подпрограммой из текста
+    if (_features & MODULO)
+        write("namespace axx_rt { inline int mod(int a, int b) { int r = a % b; return r != 0 && (r < 0) != (b < 0) ? r + b : r; } }\n");
+}
+unsigned int CodeEmittingNodeVisitor::used() const
+{
+    return features;
+}
+void CodeEmittingNodeVisitor::statement(BaseASTNode *_node)
 {
-    write(_acceptor->return_type);
+    _node->accept(this);
+    write(";\n");
+}
+void CodeEmittingNodeVisitor::signature(Leaf *_return_type, Leaf *_id, FormalParamsNode *_params)
+{
+    if (_return_type != nullptr) {
+        write(_return_type);
+    } else {
+        write("void");
+    }
     write(" ");
-    write(_acceptor->id);
+    write(_id);
     write("(");
-    _acceptor->formal_params->accept(this);
-    write(")\n");
+    _params->accept(this);
+    write(")");
+}
+void CodeEmittingNodeVisitor::declaration(BaseASTNode *_node)
+{
+    if (auto function = dynamic_cast<FunctionNode *>(_node)) {
+        signature(function->return_type, function->id, function->formal_params);
+        write(";\n");
+    } else if (auto procedure = dynamic_cast<ProcedureNode *>(_node)) {
+        signature(nullptr, procedure->id, procedure->formal_params);
+        write(";\n");
+    }
+}
+void CodeEmittingNodeVisitor::visitFunctionNode(FunctionNode *_acceptor)
+{
+    signature(_acceptor->return_type, _acceptor->id, _acceptor->formal_params);
+    write("\n");
     this->block_declarations = _acceptor->var_declarations;
     _acceptor->body->accept(this);
 }
 void CodeEmittingNodeVisitor::visitProcedureNode(ProcedureNode *_acceptor)
 {
-    write("void");
-    write(" ");
-    write(_acceptor->id);
-    write("(");
-    _acceptor->formal_params->accept(this);
-    write(")\n");
+    signature(nullptr, _acceptor->id, _acceptor->formal_params);
+    write("\n");
     this->block_declarations = _acceptor->var_declarations;
     _acceptor->body->accept(this);
 }
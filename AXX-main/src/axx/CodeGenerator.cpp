@@ -1,11 +1,151 @@
 #include <axx/codegen/CodeGenerator.hpp>
+#include <axx/AST/ASTNode.hpp>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    // Перезаписывает файл, только если текст отличается: время изменения остаётся прежним
+    void replace_file(const std::string& _path, std::string_view _text)
+    {
+        std::ifstream current(_path, std::ios::binary);
+        if (current)
+        {
+            std::string old((std::istreambuf_iterator<char>(current)), std::istreambuf_iterator<char>());
+            if (old == _text)
+                return;
+        }
+        std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+        file.write(_text.data(), _text.size());
+        if (!file)
+            throw std::runtime_error("Cannot write " + _path);
+    }
+}
+
+std::vector<BaseASTNode*> CodeGenerator::units(AST *_ast)
+{
+    if (auto program = dynamic_cast<ProgramNode*>(_ast->getRoot()))
+        return program->children;
+    return {_ast->getRoot()};
+}
+
+unsigned int CodeGenerator::emit(const std::vector<BaseASTNode*>& _units, std::vector<OutputBuffer>& _parts)
+{
+    std::atomic<std::size_t> next(0);
+    std::atomic<unsigned int> features(0);
+    auto work = [&]() {
+        for (std::size_t i = next++; i < _units.size(); i = next++)
+        {
+            CodeEmittingNodeVisitor unit(_parts[i], interner);
+            unit.statement(_units[i]);
+            features |= unit.used();
+        }
+    };
+
+    std::size_t count = std::min<std::size_t>(threads, _units.size());
+    if (count <= 1)
+    {
+        work();
+        return features;
+    }
+    std::vector<std::future<void>> workers;
+    for (std::size_t i = 0; i < count; i++)
+        workers.push_back(std::async(std::launch::async, work));
+    for (auto& worker : workers)
+        worker.get();
+    return features;
+}
+
+unsigned int CodeGenerator::declare(const std::vector<BaseASTNode*>& _units, OutputBuffer& _declarations)
+{
+    CodeEmittingNodeVisitor declarator(_declarations, interner);
+    for (auto unit : _units)
+        declarator.declaration(unit);
+    return declarator.used();
+}
 
 void CodeGenerator::generate(AST *_ast)
 {
-    _ast->accept(visitor.get());
+    // Каждая инструкция верхнего уровня выводится своим посетителем в свой буфер
+    auto statements = units(_ast);
+    std::vector<OutputBuffer> parts(statements.size());
+    unsigned int features = emit(statements, parts);
+    OutputBuffer declarations;
+    features |= declare(statements, declarations);
+
+    visitor->prologue(features);
+    output.append(declarations.text());
+    for (auto& part : parts)
+        output.append(part.text());
+    output.flush();
+}
+
+void CodeGenerator::generateShards(AST *_ast, const std::string& _base, unsigned int _shards)
+{
+    auto statements = units(_ast);
+    std::vector<OutputBuffer> parts(statements.size());
+    unsigned int features = emit(statements, parts);
+
+    OutputBuffer declarations;
+    features |= declare(statements, declarations);
+
+    OutputBuffer header;
+    CodeEmittingNodeVisitor(header, interner).prologue(features);
+    header.append(declarations.text());
+    replace_file(_base + ".hpp", "#pragma once\n" + std::string(header.text()));
+
+    std::size_t total = 0;
+    for (auto& part : parts)
+        total += part.text().size();
+
+    // Инструкция попадает в участок, на который приходится её середина: участки идут подряд
+    // и различаются по размеру не больше чем на одну подпрограмму
+    std::vector<OutputBuffer> shards(_shards);
+    std::string include = "#include \"" + _base.substr(_base.find_last_of("/\\") + 1) + ".hpp\"\n";
+    for (auto& shard : shards)
+        shard.append(include);
+    std::size_t offset = 0;
+    for (auto& part : parts)
+    {
+        std::size_t size = part.text().size();
+        std::size_t shard = total ? (offset + size / 2) * _shards / total : 0;
+        shards[std::min<std::size_t>(shard, _shards - 1)].append(part.text());
+        offset += size;
+    }
+
+    for (unsigned int i = 0; i < _shards; i++)
+        replace_file(_base + "_" + std::to_string(i) + ".cpp", shards[i].text());
+}
+
+void CodeGenerator::start()
+{
+    // Что понадобится дальше, заранее не известно: подключается вся среда выполнения
+    visitor->prologue(CodeEmittingNodeVisitor::ALL_FEATURES);
+}
+
+void CodeGenerator::generateStatement(AST *_statement)
+{
+    visitor->statement(_statement->getRoot());
+}
+
+void CodeGenerator::finish()
+{
+    output.flush();
 }
 
-CodeGenerator::CodeGenerator(std::ostream& _stream)
+CodeGenerator::CodeGenerator(std::ostream& _stream, Interner& _interner, unsigned int _threads) :
+    output(_stream), interner(_interner), threads(_threads)
 {
-    visitor = std::make_unique<CodeEmittingNodeVisitor>(_stream);
+    // Посетитель создаётся до потоков: имена типов попадают в Interner здесь,
+    // и потоки потом его только читают
+    visitor = std::make_unique<CodeEmittingNodeVisitor>(output, _interner);
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
 }
@@ -0,0 +1,19 @@
+#include <axx/optimizer/ConstantFolder.hpp>
+#include <axx/optimizer/ConstantFoldingVisitor.hpp>
+#include <axx/AST/ASTNode.hpp>
+
+ConstantFolder::ConstantFolder(Interner& _interner) : interner(_interner) {}
+
+void ConstantFolder::optimize(AST *_ast)
+{
+    // Новые листья живут в области дерева; у дерева без своей области заменять нечем
+    ASTArena *arena = _ast->getArena();
+    if (!arena)
+        return;
+    ConstantFoldingVisitor visitor(*arena, interner);
+    // В потоковом режиме корнем бывает выражение верхнего уровня
+    if (auto expression = dynamic_cast<ExpressionNode*>(_ast->getRoot()))
+        _ast->setRoot(visitor.fold(expression));
+    else
+        _ast->getRoot()->accept(&visitor);
+}
@@ -0,0 +1,419 @@
+#include <axx/optimizer/ConstantFoldingVisitor.hpp>
+#include <axx/AST/ASTNode.hpp>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+namespace
+{
+    // Integer в Ada и int в выведенном коде - 32 бита: выражение, выходящее за них, не вычисляется
+    bool in_range(std::int64_t _value)
+    {
+        return _value >= std::numeric_limits<std::int32_t>::min() && _value <= std::numeric_limits<std::int32_t>::max();
+    }
+}
+
+ConstantFoldingVisitor::ConstantFoldingVisitor(ASTArena& _arena, Interner& _interner) :
+    arena(_arena), interner(_interner), folded(nullptr), constant({Constant::NONE, 0, 0, false}), pure(true)
+{
+    true_symbol = interner.intern("true");
+    false_symbol = interner.intern("false");
+}
+
+ConstantFoldingVisitor::Constant ConstantFoldingVisitor::literal(const Token& _token)
+{
+    Constant value = {Constant::NONE, 0, 0, false};
+    if (_token.getType() == Type::id)
+    {
+        symbol_t symbol = interner.symbol(_token);
+        if (symbol == true_symbol || symbol == false_symbol)
+        {
+            value.kind = Constant::BOOL;
+            value.boolean = symbol == true_symbol;
+        }
+        return value;
+    }
+    if (_token.getType() != Type::number)
+        return value;
+
+    // Вычисляются только литералы вида 123 и 1.5; с подчёркиваниями, порядком или основанием - нет
+    std::string_view text = _token.getValue();
+    std::size_t dot = text.find('.');
+    if (text.empty() || text.find_first_not_of("0123456789.") != text.npos || text.find('.', dot + 1) != text.npos ||
+        dot == 0 || dot + 1 == text.size())
+        return value;
+    if (dot == text.npos)
+    {
+        std::int64_t integer = 0;
+        for (char digit : text)
+        {
+            integer = integer * 10 + (digit - '0');
+            if (!in_range(integer))
+                return value;
+        }
+        value.kind = Constant::INTEGER;
+        value.integer = integer;
+    }
+    else
+    {
+        value.real = std::strtof(std::string(text).c_str(), nullptr);
+        if (std::isfinite(value.real))
+            value.kind = Constant::FLOAT;
+    }
+    return value;
+}
+
+Leaf* ConstantFoldingVisitor::make(const Constant& _value)
+{
+    switch (_value.kind)
+    {
+    case Constant::INTEGER:
+        return arena.make<Leaf>(Token(std::to_string(_value.integer), Type::number));
+    case Constant::BOOL:
+        return arena.make<Leaf>(Token(_value.boolean ? "true" : "false", Type::id));
+    default:
+    {
+        // Девяти значащих цифр хватает, чтобы float прочитался обратно без потерь;
+        // точка нужна, чтобы литерал остался вещественным
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.9g", static_cast<double>(_value.real));
+        std::string text(buffer);
+        if (text.find('.') == text.npos)
+        {
+            std::size_t exponent = text.find('e');
+            text.insert(exponent == text.npos ? text.size() : exponent, ".0");
+        }
+        return arena.make<Leaf>(Token(text, Type::number));
+    }
+    }
+}
+
+bool ConstantFoldingVisitor::binary(Type _op, const Constant& _left, const Constant& _right, Constant& _result)
+{
+    if (_left.kind == Constant::NONE || _left.kind != _right.kind)
+        return false;
+
+    // Сравнения одинаковы для всех типов, False < True
+    bool compared = true;
+    bool less = false, equal = false;
+    switch (_left.kind)
+    {
+    case Constant::INTEGER:
+        less = _left.integer < _right.integer;
+        equal = _left.integer == _right.integer;
+        break;
+    case Constant::FLOAT:
+        less = _left.real < _right.real;
+        equal = _left.real == _right.real;
+        break;
+    default:
+        less = !_left.boolean && _right.boolean;
+        equal = _left.boolean == _right.boolean;
+        break;
+    }
+    _result = {Constant::BOOL, 0, 0, false};
+    switch (_op)
+    {
+    case Type::equal: _result.boolean = equal; break;
+    case Type::noteq: _result.boolean = !equal; break;
+    case Type::less: _result.boolean = less; break;
+    case Type::lequal: _result.boolean = less || equal; break;
+    case Type::greater: _result.boolean = !less && !equal; break;
+    case Type::grequal: _result.boolean = !less; break;
+    default: compared = false; break;
+    }
+    if (compared)
+        return true;
+
+    _result = _left;
+    if (_left.kind == Constant::BOOL)
+    {
+        switch (_op)
+        {
+        case Type::andop: _result.boolean = _left.boolean && _right.boolean; return true;
+        case Type::orop: _result.boolean = _left.boolean || _right.boolean; return true;
+        case Type::xorop: _result.boolean = _left.boolean != _right.boolean; return true;
+        default: return false;
+        }
+    }
+
+    if (_left.kind == Constant::FLOAT)
+    {
+        switch (_op)
+        {
+        case Type::plus: _result.real = _left.real + _right.real; break;
+        case Type::minus: _result.real = _left.real - _right.real; break;
+        case Type::star: _result.real = _left.real * _right.real; break;
+        case Type::div:
+            if (_right.real == 0)
+                return false;
+            _result.real = _left.real / _right.real;
+            break;
+        default: return false;
+        }
+        return std::isfinite(_result.real);
+    }
+
+    // Деление на ноль и переполнение в Ada - Constraint_Error во время выполнения, такие выражения остаются как есть
+    std::int64_t a = _left.integer, b = _right.integer;
+    switch (_op)
+    {
+    case Type::plus: _result.integer = a + b; break;
+    case Type::minus: _result.integer = a - b; break;
+    case Type::star: _result.integer = a * b; break;
+    case Type::div:
+        // Деление округляет к нулю, как в C++
+        if (b == 0)
+            return false;
+        _result.integer = a / b;
+        break;
+    case Type::remkw:
+        // Знак rem - знак делимого, как у % в C++
+        if (b == 0)
+            return false;
+        _result.integer = a % b;
+        break;
+    case Type::mod:
+        // Знак mod - знак делителя: -7 mod 3 = 2, а -7 % 3 в C++ = -1
+        if (b == 0)
+            return false;
+        _result.integer = a % b;
+        if (_result.integer != 0 && (_result.integer < 0) != (b < 0))
+            _result.integer += b;
+        break;
+    case Type::power:
+        // Отрицательная степень целого в Ada - ошибка
+        if (b < 0)
+            return false;
+        _result.integer = 1;
+        for (std::int64_t i = 0; i < b && _result.integer != 0; i++)
+        {
+            _result.integer *= a;
+            if (!in_range(_result.integer))
+                return false;
+            // Дальше значение не меняется
+            if (_result.integer == 1 && a == 1)
+                break;
+            if (a == -1)
+            {
+                _result.integer = b % 2 ? -1 : 1;
+                break;
+            }
+        }
+        break;
+    default:
+        return false;
+    }
+    return in_range(_result.integer);
+}
+
+ExpressionNode* ConstantFoldingVisitor::fold(ExpressionNode* _expression)
+{
+    _expression->accept(this);
+    return folded;
+}
+
+void ConstantFoldingVisitor::fold(BaseASTNode*& _node)
+{
+    // Выражение может стоять в блоке как отдельная инструкция
+    if (auto expression = dynamic_cast<ExpressionNode*>(_node))
+        _node = fold(expression);
+    else
+        _node->accept(this);
+}
+
+void ConstantFoldingVisitor::visitLeaf(Leaf *_acceptor)
+{
+    constant = literal(_acceptor->token);
+    folded = _acceptor;
+    pure = true;
+}
+
+void ConstantFoldingVisitor::visitFormalParamsNode(FormalParamsNode *) {}
+
+void ConstantFoldingVisitor::visitActualParamsNode(ActualParamsNode *_acceptor)
+{
+    for (auto& param : _acceptor->params)
+        param = fold(param);
+}
+
+void ConstantFoldingVisitor::visitCallNode(CallNode *_acceptor)
+{
+    _acceptor->params->accept(this);
+    constant.kind = Constant::NONE;
+    folded = _acceptor;
+    pure = false;
+}
+
+void ConstantFoldingVisitor::visitBinaryNode(BinaryNode *_acceptor)
+{
+    _acceptor->left = fold(_acceptor->left);
+    Constant left = constant;
+    bool left_pure = pure;
+    _acceptor->right = fold(_acceptor->right);
+    Constant right = constant;
+    bool right_pure = pure;
+
+    Type op = _acceptor->op->token.getType();
+    Constant result;
+    if (binary(op, left, right, result))
+    {
+        constant = result;
+        folded = make(result);
+        pure = true;
+        return;
+    }
+
+    constant.kind = Constant::NONE;
+    folded = _acceptor;
+    pure = left_pure && right_pure;
+    if (op != Type::andop && op != Type::orop)
+        return;
+
+    // Известен один операнд and или or: true and X = X, false or X = X. Поглощающее значение
+    // (false для and, true для or) заменяет всё выражение, только если другой операнд без вызовов:
+    // в Ada and и or вычисляют оба операнда
+    bool neutral = op == Type::andop;
+    if (left.kind == Constant::BOOL)
+    {
+        if (left.boolean == neutral)
+        {
+            folded = _acceptor->right;
+            constant = right;
+            pure = right_pure;
+        }
+        else if (right_pure)
+        {
+            folded = _acceptor->left;
+            constant = left;
+        }
+    }
+    else if (right.kind == Constant::BOOL)
+    {
+        if (right.boolean == neutral)
+        {
+            folded = _acceptor->left;
+            constant = left;
+            pure = left_pure;
+        }
+        else if (left_pure)
+        {
+            folded = _acceptor->right;
+            constant = right;
+        }
+    }
+}
+
+void ConstantFoldingVisitor::visitUnaryNode(UnaryNode *_acceptor)
+{
+    _acceptor->operand = fold(_acceptor->operand);
+    Constant result = constant;
+    bool known = false;
+    switch (_acceptor->op->token.getType())
+    {
+    case Type::plus:
+        known = result.kind == Constant::INTEGER || result.kind == Constant::FLOAT;
+        break;
+    case Type::minus:
+        if (result.kind == Constant::INTEGER)
+        {
+            result.integer = -result.integer;
+            known = in_range(result.integer);
+        }
+        else if (result.kind == Constant::FLOAT)
+        {
+            result.real = -result.real;
+            known = true;
+        }
+        break;
+    case Type::notop:
+        result.boolean = !result.boolean;
+        known = result.kind == Constant::BOOL;
+        break;
+    default:
+        break;
+    }
+
+    if (known)
+    {
+        constant = result;
+        folded = make(result);
+    }
+    else
+    {
+        constant.kind = Constant::NONE;
+        folded = _acceptor;
+    }
+}
+
+void ConstantFoldingVisitor::visitAssignmentNode(AssignmentNode *_acceptor)
+{
+    _acceptor->right = fold(_acceptor->right);
+}
+
+void ConstantFoldingVisitor::visitReturnNode(ReturnNode *_acceptor)
+{
+    _acceptor->return_value = fold(_acceptor->return_value);
+}
+
+void ConstantFoldingVisitor::visitBlockNode(BlockNode *_acceptor)
+{
+    for (auto& child : _acceptor->children)
+        fold(child);
+}
+
+void ConstantFoldingVisitor::visitProgramNode(ProgramNode *_acceptor)
+{
+    for (auto& child : _acceptor->children)
+        fold(child);
+}
+
+void ConstantFoldingVisitor::visitFunctionNode(FunctionNode *_acceptor)
+{
+    _acceptor->body->accept(this);
+}
+
+void ConstantFoldingVisitor::visitProcedureNode(ProcedureNode *_acceptor)
+{
+    _acceptor->body->accept(this);
+}
+
+void ConstantFoldingVisitor::visitElseNode(ElseNode *_acceptor)
+{
+    _acceptor->body->accept(this);
+}
+
+void ConstantFoldingVisitor::visitElifNode(ElifNode *_acceptor)
+{
+    _acceptor->condition = fold(_acceptor->condition);
+    _acceptor->body->accept(this);
+    if (_acceptor->next_elif)
+        _acceptor->next_elif->accept(this);
+    if (_acceptor->next_else)
+        _acceptor->next_else->accept(this);
+}
+
+void ConstantFoldingVisitor::visitIfNode(IfNode *_acceptor)
+{
+    _acceptor->condition = fold(_acceptor->condition);
+    _acceptor->body->accept(this);
+    if (_acceptor->next_elif)
+        _acceptor->next_elif->accept(this);
+    if (_acceptor->next_else)
+        _acceptor->next_else->accept(this);
+}
+
+void ConstantFoldingVisitor::visitWhileNode(WhileNode *_acceptor)
+{
+    _acceptor->condition = fold(_acceptor->condition);
+    _acceptor->body->accept(this);
+}
+
+void ConstantFoldingVisitor::visitForNode(ForNode *_acceptor)
+{
+    _acceptor->body->accept(this);
+}
+
+void ConstantFoldingVisitor::visitVarDeclNode(VariableDeclarationNode *) {}
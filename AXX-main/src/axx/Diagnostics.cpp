@@ -0,0 +1,105 @@
+#include <axx/token/Diagnostics.hpp>
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    std::string place(const Token& _at)
+    {
+        return std::to_string(_at.getRow()) + " position: " + std::to_string(_at.getPos()) + "\n";
+    }
+}
+
+std::string Diagnostic::render() const
+{
+    switch (problem)
+    {
+    case Problem::Syntax:
+        return std::string(context) +
+            " pos=" + std::to_string(token.getPos()) + " row=" + std::to_string(token.getRow()) +
+            " type=" + type_to_str(token.getType()) + " value=" + std::string(token.getValue());
+    case Problem::Undefined:
+        return "Name " + std::string(token.getValue()) + " is undefined\nOccured at row: " + place(at);
+    case Problem::AlreadyDefined:
+        return "Name " + std::string(token.getValue()) + " is already defined\nDefined second time at row : " + place(at);
+    case Problem::AssignToParameter:
+        return "Parameter " + std::string(token.getValue()) + " cannot be assigned\nOccured at row: " + place(at);
+    case Problem::NotCallable:
+        return "Not a callable at row: " + place(at);
+    case Problem::ParameterCount:
+        return "Parameter quantity mismatch occured at row: " + place(at);
+    case Problem::ParameterType:
+        return "Parameter type mismatch occured at row: " + place(at);
+    case Problem::TypeMismatch:
+        return "Type mismatch occured at row: " + place(at);
+    case Problem::ConditionNotBool:
+        return "Condition type is not Bool.\nOccured at row: " + place(at);
+    }
+    return "";
+}
+
+Diagnostics::Diagnostics() : errors(0) {}
+
+void Diagnostics::report(const Diagnostic& _diagnostic)
+{
+    entries.push_back(_diagnostic);
+    if (_diagnostic.severity == Severity::Error)
+        errors++;
+}
+
+void Diagnostics::error(Problem _problem, const Token& _token)
+{
+    report({Severity::Error, _problem, _token, _token, nullptr});
+}
+
+void Diagnostics::error(Problem _problem, const Token& _token, const Token& _at)
+{
+    report({Severity::Error, _problem, _token, _at, nullptr});
+}
+
+void Diagnostics::append(const Diagnostics& _other)
+{
+    entries.insert(entries.end(), _other.entries.begin(), _other.entries.end());
+    errors += _other.errors;
+}
+
+std::size_t Diagnostics::errorCount() const
+{
+    return errors;
+}
+
+const std::vector<Diagnostic>& Diagnostics::all() const
+{
+    return entries;
+}
+
+std::vector<Diagnostic> Diagnostics::ordered() const
+{
+    // Сообщение без координат остаётся за тем, что было записано перед ним
+    std::vector<std::uint32_t> places(entries.size());
+    std::uint32_t last = 0;
+    for (std::size_t i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].at.getRow() != 0)
+            last = entries[i].at.getPlace();
+        places[i] = last;
+    }
+
+    std::vector<std::size_t> order(entries.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t _a, std::size_t _b) { return places[_a] < places[_b]; });
+
+    std::vector<Diagnostic> result;
+    result.reserve(entries.size());
+    for (std::size_t i : order)
+        result.push_back(entries[i]);
+    return result;
+}
+
+void Diagnostics::print(std::ostream& _stream) const
+{
+    for (auto& diagnostic : ordered())
+    {
+        _stream << diagnostic.render() << std::endl;
+    }
+}
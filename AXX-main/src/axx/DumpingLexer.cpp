@@ -0,0 +1,35 @@
+#include <axx/lexer/DumpingLexer.hpp>
+
+DumpingLexer::DumpingLexer(LexerInterface &_lexer, std::ostream &_out) : lexer(_lexer), out(_out) {}
+
+void DumpingLexer::open(std::istream &_stream)
+{
+    lexer.open(_stream);
+}
+
+void DumpingLexer::open(const std::string &_path)
+{
+    lexer.open(_path);
+}
+
+std::shared_ptr<const SourceFile> DumpingLexer::getSource() const
+{
+    return lexer.getSource();
+}
+
+void DumpingLexer::setState(LexerStateInterface *_state)
+{
+    lexer.setState(_state);
+}
+
+Token DumpingLexer::getToken()
+{
+    Token token = lexer.getToken();
+    out << type_to_str(token.getType()) << " " << token.getValue() << "\n";
+    return token;
+}
+
+void DumpingLexer::print_all_tokens()
+{
+    lexer.print_all_tokens();
+}
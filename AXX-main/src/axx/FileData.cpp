@@ -4,13 +4,59 @@ FileData::FileData(){}
 
 Token FileData::get()
 {
-    Token tok = queue.front();
-    queue.pop();
-    return tok;
+    return queue.pop();
 }
 
-void FileData::put(Type _type, unsigned int _row, unsigned int _pos)
+void FileData::push(char _c)
+{
+    if (source && accum.empty())
+    {
+        if (length == 0 && cursor < source + sourceSize && *cursor == _c)
+        {
+            begin = cursor - source;
+            length = 1;
+            return;
+        }
+        if (length != 0 && begin + length < sourceSize && source[begin + length] == _c)
+        {
+            length++;
+            return;
+        }
+        accum.assign(source + begin, length);
+    }
+    accum.push_back(_c);
+}
+
+void FileData::push(const char* _begin, std::size_t _count)
+{
+    // Продолжение лексемы прямо в файле только удлиняет её
+    if (source && accum.empty() && length != 0 && source + begin + length == _begin)
+    {
+        length += _count;
+        return;
+    }
+    for (std::size_t i = 0; i < _count; i++)
+    {
+        cursor = _begin + i;
+        push(_begin[i]);
+    }
+}
+
+void FileData::put(Type _type, std::uint32_t _place)
+{
+    if (length != 0 && accum.empty())
+    {
+        queue.emplace(_type, sourceId, static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(length), lines, _place);
+    }
+    else
+    {
+        queue.emplace(accum, _type, lines, _place);
+    }
+    discard();
+}
+
+void FileData::discard()
 {
-    queue.emplace(accum, _type, _row, _pos);
     accum.clear();
+    length = 0;
 }
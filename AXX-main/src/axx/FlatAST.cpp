@@ -0,0 +1,461 @@
+#include <axx/AST/FlatAST.hpp>
+#include <axx/interface/NodeVisitorInterface.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#define HEADERWORDS 2
+#define TOKENWORDS (sizeof(Token) / sizeof(std::uint32_t))
+
+static_assert(sizeof(Token) % sizeof(std::uint32_t) == 0, "Token must fill whole words of the flat tree");
+
+namespace
+{
+    /// @brief Обходит дерево указателей и раскладывает узлы по массивам в порядке обхода в глубину
+    class FlatASTBuilder : public NodeVisitorInterface
+    {
+    private:
+        struct Open
+        {
+            std::uint32_t node;
+            std::uint32_t last; // Последний добавленный потомок
+        };
+        std::vector<Open> parents;
+
+        std::uint32_t open(NodeKind _kind, const Token* _token = nullptr, std::uint32_t _value = 0)
+        {
+            auto node = static_cast<std::uint32_t>(kinds.size());
+            kinds.push_back(_kind);
+            firstChild.push_back(FlatAST::NONE);
+            nextSibling.push_back(FlatAST::NONE);
+            value.push_back(_value);
+            if (_token)
+            {
+                token.push_back(static_cast<std::uint32_t>(pool.size()));
+                pool.push_back(*_token);
+            }
+            else
+            {
+                token.push_back(FlatAST::NONE);
+            }
+            if (!parents.empty())
+            {
+                Open& parent = parents.back();
+                if (parent.last == FlatAST::NONE)
+                    firstChild[parent.node] = node;
+                else
+                    nextSibling[parent.last] = node;
+                parent.last = node;
+            }
+            parents.push_back({node, FlatAST::NONE});
+            return node;
+        }
+
+        void close()
+        {
+            parents.pop_back();
+        }
+
+        void child(BaseASTNode* _node)
+        {
+            if (_node)
+            {
+                _node->accept(this);
+            }
+            else
+            {
+                open(NodeKind::Empty);
+                close();
+            }
+        }
+
+    public:
+        std::vector<NodeKind> kinds;
+        std::vector<std::uint32_t> token;
+        std::vector<std::uint32_t> firstChild;
+        std::vector<std::uint32_t> nextSibling;
+        std::vector<std::uint32_t> value;
+        std::vector<Token> pool;
+
+        void visitLeaf(Leaf* _acceptor) override
+        {
+            open(NodeKind::Leaf, &_acceptor->token);
+            close();
+        }
+        void visitFormalParamsNode(FormalParamsNode* _acceptor) override
+        {
+            // Имена и типы чередуются: имя, тип, имя, тип...
+            open(NodeKind::FormalParams);
+            for (std::size_t i = 0; i < _acceptor->names.size(); i++)
+            {
+                child(_acceptor->names[i]);
+                child(_acceptor->types[i]);
+            }
+            close();
+        }
+        void visitActualParamsNode(ActualParamsNode* _acceptor) override
+        {
+            open(NodeKind::ActualParams);
+            for (auto param : _acceptor->params)
+                child(param);
+            close();
+        }
+        void visitCallNode(CallNode* _acceptor) override
+        {
+            open(NodeKind::Call, &_acceptor->callable);
+            child(_acceptor->params);
+            close();
+        }
+        void visitBinaryNode(BinaryNode* _acceptor) override
+        {
+            open(NodeKind::Binary);
+            child(_acceptor->left);
+            child(_acceptor->op);
+            child(_acceptor->right);
+            close();
+        }
+        void visitUnaryNode(UnaryNode* _acceptor) override
+        {
+            open(NodeKind::Unary);
+            child(_acceptor->op);
+            child(_acceptor->operand);
+            close();
+        }
+        void visitAssignmentNode(AssignmentNode* _acceptor) override
+        {
+            open(NodeKind::Assignment);
+            child(_acceptor->left);
+            child(_acceptor->right);
+            close();
+        }
+        void visitReturnNode(ReturnNode* _acceptor) override
+        {
+            open(NodeKind::Return);
+            child(_acceptor->return_value);
+            close();
+        }
+        void visitBlockNode(BlockNode* _acceptor) override
+        {
+            open(NodeKind::Block);
+            for (auto node : _acceptor->children)
+                child(node);
+            close();
+        }
+        void visitProgramNode(ProgramNode* _acceptor) override
+        {
+            open(NodeKind::Program);
+            for (auto node : _acceptor->children)
+                child(node);
+            close();
+        }
+        void visitFunctionNode(FunctionNode* _acceptor) override
+        {
+            // id, параметры, тип результата, тело, затем объявления переменных
+            open(NodeKind::Function);
+            child(_acceptor->id);
+            child(_acceptor->formal_params);
+            child(_acceptor->return_type);
+            child(_acceptor->body);
+            for (auto declaration : _acceptor->var_declarations)
+                child(declaration);
+            close();
+        }
+        void visitProcedureNode(ProcedureNode* _acceptor) override
+        {
+            open(NodeKind::Procedure);
+            child(_acceptor->id);
+            child(_acceptor->formal_params);
+            child(_acceptor->body);
+            for (auto declaration : _acceptor->var_declarations)
+                child(declaration);
+            close();
+        }
+        void visitElseNode(ElseNode* _acceptor) override
+        {
+            open(NodeKind::Else);
+            child(_acceptor->body);
+            close();
+        }
+        void visitElifNode(ElifNode* _acceptor) override
+        {
+            open(NodeKind::Elif);
+            child(_acceptor->condition);
+            child(_acceptor->body);
+            child(_acceptor->next_elif);
+            child(_acceptor->next_else);
+            close();
+        }
+        void visitIfNode(IfNode* _acceptor) override
+        {
+            open(NodeKind::If);
+            child(_acceptor->condition);
+            child(_acceptor->body);
+            child(_acceptor->next_elif);
+            child(_acceptor->next_else);
+            close();
+        }
+        void visitWhileNode(WhileNode* _acceptor) override
+        {
+            open(NodeKind::While);
+            child(_acceptor->condition);
+            child(_acceptor->body);
+            close();
+        }
+        void visitForNode(ForNode* _acceptor) override
+        {
+            open(NodeKind::For);
+            child(_acceptor->iterator);
+            child(_acceptor->from);
+            child(_acceptor->to);
+            child(_acceptor->body);
+            close();
+        }
+        void visitVarDeclNode(VariableDeclarationNode* _acceptor) override
+        {
+            open(NodeKind::VariableDeclaration, &_acceptor->var_name, static_cast<std::uint32_t>(_acceptor->size));
+            child(_acceptor->type);
+            close();
+        }
+    };
+
+    template <typename T>
+    T* as(BaseASTNode* _node)
+    {
+        // Пустой узел превращается в nullptr
+        return _node ? static_cast<T*>(_node) : nullptr;
+    }
+}
+
+std::size_t FlatAST::kindsAt() const
+{
+    return HEADERWORDS;
+}
+
+std::size_t FlatAST::tokenAt() const
+{
+    return kindsAt() + (nodes + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t);
+}
+
+std::size_t FlatAST::firstChildAt() const
+{
+    return tokenAt() + nodes;
+}
+
+std::size_t FlatAST::nextSiblingAt() const
+{
+    return firstChildAt() + nodes;
+}
+
+std::size_t FlatAST::valueAt() const
+{
+    return nextSiblingAt() + nodes;
+}
+
+std::size_t FlatAST::poolAt() const
+{
+    return valueAt() + nodes;
+}
+
+void FlatAST::layout(std::uint32_t _nodes, std::uint32_t _tokens)
+{
+    nodes = _nodes;
+    tokens = _tokens;
+    storage.assign(poolAt() + tokens * TOKENWORDS, 0);
+    storage[0] = nodes;
+    storage[1] = tokens;
+}
+
+FlatAST::FlatAST(BaseASTNode* _root)
+{
+    FlatASTBuilder builder;
+    if (_root)
+        _root->accept(&builder);
+    layout(static_cast<std::uint32_t>(builder.kinds.size()), static_cast<std::uint32_t>(builder.pool.size()));
+
+    std::memcpy(&storage[kindsAt()], builder.kinds.data(), nodes * sizeof(NodeKind));
+    std::memcpy(&storage[tokenAt()], builder.token.data(), nodes * sizeof(std::uint32_t));
+    std::memcpy(&storage[firstChildAt()], builder.firstChild.data(), nodes * sizeof(std::uint32_t));
+    std::memcpy(&storage[nextSiblingAt()], builder.nextSibling.data(), nodes * sizeof(std::uint32_t));
+    std::memcpy(&storage[valueAt()], builder.value.data(), nodes * sizeof(std::uint32_t));
+    std::memcpy(&storage[poolAt()], builder.pool.data(), tokens * sizeof(Token));
+}
+
+FlatAST::FlatAST(const void* _data, std::size_t _bytes)
+{
+    std::uint32_t header[HEADERWORDS];
+    if (_bytes < sizeof(header))
+        throw std::invalid_argument("Flat AST buffer is too short");
+    std::memcpy(header, _data, sizeof(header));
+    layout(header[0], header[1]);
+    if (_bytes != bytes())
+        throw std::invalid_argument("Flat AST buffer size doesn't match its header");
+    std::memcpy(storage.data(), _data, _bytes);
+}
+
+std::uint32_t FlatAST::size() const
+{
+    return nodes;
+}
+
+NodeKind FlatAST::kind(std::uint32_t _node) const
+{
+    return reinterpret_cast<const NodeKind*>(&storage[kindsAt()])[_node];
+}
+
+bool FlatAST::hasToken(std::uint32_t _node) const
+{
+    return storage[tokenAt() + _node] != NONE;
+}
+
+Token FlatAST::token(std::uint32_t _node) const
+{
+    Token result(Type::unexpected, 0, 0, 0);
+    std::memcpy(static_cast<void*>(&result), &storage[poolAt() + storage[tokenAt() + _node] * TOKENWORDS], sizeof(Token));
+    return result;
+}
+
+std::uint32_t FlatAST::firstChild(std::uint32_t _node) const
+{
+    return storage[firstChildAt() + _node];
+}
+
+std::uint32_t FlatAST::nextSibling(std::uint32_t _node) const
+{
+    return storage[nextSiblingAt() + _node];
+}
+
+std::uint32_t FlatAST::value(std::uint32_t _node) const
+{
+    return storage[valueAt() + _node];
+}
+
+const void* FlatAST::data() const
+{
+    return storage.data();
+}
+
+std::size_t FlatAST::bytes() const
+{
+    return storage.size() * sizeof(std::uint32_t);
+}
+
+BaseASTNode* FlatAST::expand(std::uint32_t _node, ASTArena& _arena) const
+{
+    std::vector<BaseASTNode*> children;
+    for (std::uint32_t c = firstChild(_node); c != NONE; c = nextSibling(c))
+        children.push_back(expand(c, _arena));
+
+    switch (kind(_node))
+    {
+    case NodeKind::Empty:
+        return nullptr;
+    case NodeKind::VariableDeclaration:
+        return _arena.make<VariableDeclarationNode>(token(_node), as<Leaf>(children[0]), static_cast<int>(value(_node)));
+    case NodeKind::Leaf:
+        return _arena.make<Leaf>(token(_node));
+    case NodeKind::FormalParams:
+    {
+        auto params = _arena.make<FormalParamsNode>(std::vector<Leaf*>(), std::vector<Leaf*>());
+        for (std::size_t i = 0; i + 1 < children.size(); i += 2)
+            params->add_param(as<Leaf>(children[i]), as<Leaf>(children[i + 1]));
+        return params;
+    }
+    case NodeKind::ActualParams:
+    {
+        auto params = _arena.make<ActualParamsNode>(std::vector<ExpressionNode*>());
+        for (auto child : children)
+            params->add_child(as<ExpressionNode>(child));
+        return params;
+    }
+    case NodeKind::Call:
+        return _arena.make<CallNode>(token(_node), as<ActualParamsNode>(children[0]));
+    case NodeKind::Binary:
+        return _arena.make<BinaryNode>(as<ExpressionNode>(children[0]), as<Leaf>(children[1]), as<ExpressionNode>(children[2]));
+    case NodeKind::Unary:
+        return _arena.make<UnaryNode>(as<Leaf>(children[0]), as<ExpressionNode>(children[1]));
+    case NodeKind::Assignment:
+        return _arena.make<AssignmentNode>(as<Leaf>(children[0]), as<ExpressionNode>(children[1]));
+    case NodeKind::Return:
+        return _arena.make<ReturnNode>(as<ExpressionNode>(children[0]));
+    case NodeKind::Block:
+        return _arena.make<BlockNode>(children);
+    case NodeKind::Program:
+    {
+        auto program = _arena.make<ProgramNode>();
+        for (auto child : children)
+            program->add_child(child);
+        return program;
+    }
+    case NodeKind::Function:
+    {
+        std::vector<VariableDeclarationNode*> declarations;
+        for (std::size_t i = 4; i < children.size(); i++)
+            declarations.push_back(as<VariableDeclarationNode>(children[i]));
+        return _arena.make<FunctionNode>(as<Leaf>(children[0]), as<FormalParamsNode>(children[1]), as<Leaf>(children[2]),
+                                         as<BlockNode>(children[3]), declarations);
+    }
+    case NodeKind::Procedure:
+    {
+        std::vector<VariableDeclarationNode*> declarations;
+        for (std::size_t i = 3; i < children.size(); i++)
+            declarations.push_back(as<VariableDeclarationNode>(children[i]));
+        return _arena.make<ProcedureNode>(as<Leaf>(children[0]), as<FormalParamsNode>(children[1]), as<BlockNode>(children[2]), declarations);
+    }
+    case NodeKind::Else:
+        return _arena.make<ElseNode>(as<BlockNode>(children[0]));
+    case NodeKind::Elif:
+    {
+        auto elif = _arena.make<ElifNode>(as<ExpressionNode>(children[0]), as<BlockNode>(children[1]));
+        elif->next_elif = as<ElifNode>(children[2]);
+        elif->next_else = as<ElseNode>(children[3]);
+        return elif;
+    }
+    case NodeKind::If:
+    {
+        auto ifNode = _arena.make<IfNode>(as<ExpressionNode>(children[0]), as<BlockNode>(children[1]));
+        ifNode->next_elif = as<ElifNode>(children[2]);
+        ifNode->next_else = as<ElseNode>(children[3]);
+        return ifNode;
+    }
+    case NodeKind::While:
+        return _arena.make<WhileNode>(as<ExpressionNode>(children[0]), as<BlockNode>(children[1]));
+    case NodeKind::For:
+        return _arena.make<ForNode>(as<Leaf>(children[0]), as<Leaf>(children[1]), as<Leaf>(children[2]), as<BlockNode>(children[3]));
+    }
+    throw std::runtime_error("Unknown flat AST node kind");
+}
+
+std::unique_ptr<AST> FlatAST::expand(std::shared_ptr<const SourceFile> _source) const
+{
+    auto arena = std::make_unique<ASTArena>();
+    BaseASTNode* root = nodes ? expand(0, *arena) : nullptr;
+    return std::make_unique<AST>(root, std::move(_source), std::move(arena));
+}
+
+void FlatAST::accept(FlatVisitorInterface& _visitor) const
+{
+    if (nodes == 0)
+        return;
+    std::vector<std::uint32_t> open;
+    std::uint32_t node = 0;
+    while (true)
+    {
+        if (_visitor.enter(*this, node) && firstChild(node) != NONE)
+        {
+            open.push_back(node);
+            node = firstChild(node);
+            continue;
+        }
+        _visitor.leave(*this, node);
+        // Поднимаемся к ближайшему предку, у которого есть следующий брат
+        while (nextSibling(node) == NONE)
+        {
+            if (open.empty())
+                return;
+            node = open.back();
+            open.pop_back();
+            _visitor.leave(*this, node);
+        }
+        node = nextSibling(node);
+    }
+}
@@ -0,0 +1,85 @@
+#include <axx/lexer/InputBuffer.hpp>
+#define CHARCOUNT 1000
+
+void InputBuffer::open(std::istream &_stream)
+{
+    source.reset();
+    currBuff.reset(new std::string(CHARCOUNT + 1, '\0'));
+    otherBuff.reset(new std::string());
+
+    this->stream = &_stream;
+    streamLines.reset(new LineIndex());
+    base = 0;
+    filled = 0;
+
+    iter = currBuff->data();
+    end = iter;
+    origin = iter;
+    read();
+}
+
+bool InputBuffer::read()
+{
+    // Порция кончается на последнем прочитанном символе: лексема, которую она разрезала, продолжается
+    // в следующей, а завершающий '\0' лексер передаёт сам, когда поток исчерпан
+    otherBuff->assign(CHARCOUNT + 1, '\0');
+    this->stream->read(&(*otherBuff)[0], CHARCOUNT);
+    auto count = static_cast<std::uint32_t>(this->stream->gcount());
+    // Поток исчерпан: текущая порция остаётся на месте, лексер дочитывает её до конца
+    if (count == 0)
+        return false;
+
+    base += filled;
+    filled = count;
+    currBuff.swap(otherBuff);
+    streamLines->feed(currBuff->data(), filled, base);
+    iter = currBuff->data();
+    end = iter + filled;
+    origin = iter;
+    return true;
+}
+
+void InputBuffer::open(std::shared_ptr<const SourceFile> _source)
+{
+    std::size_t size = _source->getSize();
+    open(std::move(_source), 0, size);
+}
+
+void InputBuffer::open(std::shared_ptr<const SourceFile> _source, std::size_t _begin, std::size_t _end)
+{
+    stream = nullptr;
+    currBuff.reset();
+    otherBuff.reset();
+    streamLines.reset();
+    source = std::move(_source);
+
+    // Лексер читает отображение напрямую, без промежуточных буферов
+    origin = source->getData();
+    base = 0;
+    iter = source->getData() + _begin;
+    end = source->getData() + _end;
+}
+
+bool InputBuffer::refill()
+{
+    // Отображённый файл доступен целиком, дочитывать нечего
+    if (source)
+        return false;
+
+    return read();
+}
+
+bool InputBuffer::isMapped() const
+{
+    return source != nullptr;
+}
+
+std::shared_ptr<const SourceFile> InputBuffer::getSource() const
+{
+    return source;
+}
+
+std::uint16_t InputBuffer::getLines() const
+{
+    return source ? source->getLines().getId() : streamLines->getId();
+}
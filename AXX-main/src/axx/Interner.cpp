@@ -0,0 +1,138 @@
+#include <axx/token/Interner.hpp>
+#include <axx/token/TextStorage.hpp>
+
+#define INITIALSLOTS 1024
+#define FIRSTCHUNK 10 // В первом участке написаний 1 << FIRSTCHUNK номеров
+
+namespace
+{
+    inline char fold(char _c)
+    {
+        return (_c >= 'A' && _c <= 'Z') ? static_cast<char>(_c + ('a' - 'A')) : _c;
+    }
+
+    // FNV-1a по символам, приведённым к нижнему регистру
+    inline std::uint32_t hash(std::string_view _spelling)
+    {
+        std::uint32_t h = 2166136261u;
+        for (char c : _spelling)
+        {
+            h ^= static_cast<unsigned char>(fold(c));
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    // Участок написания и место в нём: участок k начинается с номера (1 << (k + FIRSTCHUNK)) - (1 << FIRSTCHUNK)
+    inline std::size_t chunk(symbol_t _symbol, std::size_t& _index)
+    {
+        const std::uint64_t n = std::uint64_t(_symbol) + (1u << FIRSTCHUNK);
+        std::size_t k = 0;
+        while (n >> (k + FIRSTCHUNK + 1))
+            k++;
+        _index = static_cast<std::size_t>(n - (std::uint64_t(1) << (k + FIRSTCHUNK)));
+        return k;
+    }
+
+    inline bool equal(std::string_view _a, std::string_view _b)
+    {
+        if (_a.size() != _b.size())
+            return false;
+        for (std::size_t i = 0; i < _a.size(); i++)
+        {
+            if (fold(_a[i]) != fold(_b[i]))
+                return false;
+        }
+        return true;
+    }
+}
+
+Interner::Interner() : count(0), slots(INITIALSLOTS, 0)
+{
+    area = TextStorage::attach(this);
+}
+
+Interner::~Interner()
+{
+    TextStorage::detach(area);
+}
+
+void Interner::grow()
+{
+    std::vector<symbol_t> bigger(slots.size() * 2, 0);
+    const std::size_t mask = bigger.size() - 1;
+    for (symbol_t id = 0; id < count; id++)
+    {
+        std::size_t i = hashes[id] & mask;
+        while (bigger[i])
+            i = (i + 1) & mask;
+        bigger[i] = id + 1;
+    }
+    slots.swap(bigger);
+}
+
+symbol_t Interner::intern(std::string_view _spelling)
+{
+    const std::uint32_t h = hash(_spelling);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::size_t mask = slots.size() - 1;
+    std::size_t i = h & mask;
+    while (slots[i])
+    {
+        symbol_t id = slots[i] - 1;
+        if (hashes[id] == h && equal(spelling(id), _spelling))
+            return id;
+        i = (i + 1) & mask;
+    }
+
+    // Написание копируется в блоки сеанса этой таблицы: оно не зависит от времени жизни исходного
+    // файла и освобождается вместе с таблицей
+    std::uint16_t source;
+    std::uint32_t offset;
+    TextStorage::store(_spelling, source, offset, area);
+    symbol_t id = count++;
+    std::size_t index;
+    std::size_t k = chunk(id, index);
+    if (!chunks[k])
+        chunks[k].reset(new std::string_view[std::size_t(1) << (k + FIRSTCHUNK)]);
+    chunks[k][index] = TextStorage::view(source, offset, static_cast<std::uint32_t>(_spelling.size()));
+    hashes.push_back(h);
+    slots[i] = id + 1;
+
+    if (std::size_t(count) * 2 > slots.size())
+        grow();
+    return id;
+}
+
+symbol_t Interner::symbol(const Token& _token)
+{
+    if (_token.getSource() == area)
+        return _token.getSymbol();
+    return intern(_token.getValue());
+}
+
+Token Interner::token(std::string_view _spelling, Type _type)
+{
+    Token tok(_type, 0, 0, 0);
+    tok.setSymbol(area, intern(_spelling), static_cast<std::uint32_t>(_spelling.size()));
+    return tok;
+}
+
+void Interner::attach(Token& _token)
+{
+    std::string_view value = _token.getValue();
+    _token.setSymbol(area, intern(value), static_cast<std::uint32_t>(value.size()));
+}
+
+std::string_view Interner::spelling(symbol_t _symbol) const
+{
+    std::size_t index;
+    std::size_t k = chunk(_symbol, index);
+    return chunks[k][index];
+}
+
+std::uint16_t Interner::getArea() const
+{
+    return area;
+}
@@ -0,0 +1,155 @@
+#include <axx/lexer/Keywords.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace
+{
+    struct Keyword
+    {
+        std::string_view name;
+        Type type;
+    };
+
+    constexpr Keyword keywords[] = {
+        {"if", Type::ifkw},
+        {"elsif", Type::elsifkw},
+        {"else", Type::elsekw},
+        {"for", Type::forkw},
+        {"while", Type::whilekw},
+        {"return", Type::returnkw},
+        {"abort", Type::abortkw},
+        {"abs", Type::abskw},
+        {"abstract", Type::abstractkw},
+        {"accept", Type::acceptkw},
+        {"access", Type::accesskw},
+        {"aliased", Type::aliasedkw},
+        {"all", Type::allkw},
+        {"array", Type::arraykw},
+        {"at", Type::atkw},
+        {"begin", Type::beginkw},
+        {"body", Type::bodykw},
+        {"case", Type::casekw},
+        {"constant", Type::constantkw},
+        {"declare", Type::declarekw},
+        {"delay", Type::delaykw},
+        {"delta", Type::deltakw},
+        {"digits", Type::digitskw},
+        {"do", Type::dokw},
+        {"end", Type::endkw},
+        {"entry", Type::entrykw},
+        {"exception", Type::exceptionkw},
+        {"exit", Type::exitkw},
+        {"function", Type::functionkw},
+        {"generic", Type::generickw},
+        {"goto", Type::gotokw},
+        {"interface", Type::interfacekw},
+        {"limited", Type::limitedkw},
+        {"loop", Type::loopkw},
+        {"new", Type::newkw},
+        {"null", Type::nullkw},
+        {"of", Type::ofkw},
+        {"others", Type::otherskw},
+        {"out", Type::outkw},
+        {"overrid", Type::overridkw},
+        {"package", Type::packagekw},
+        {"pragma", Type::pragmakw},
+        {"private", Type::privatekw},
+        {"procedure", Type::procedurekw},
+        {"protected", Type::protectedkw},
+        {"raise", Type::raisekw},
+        {"range", Type::rangekw},
+        {"record", Type::recordkw},
+        {"rem", Type::remkw},
+        {"renames", Type::renameskw},
+        {"requeue", Type::requeuekw},
+        {"reverse", Type::reversekw},
+        {"select", Type::selectkw},
+        {"separate", Type::separatekw},
+        {"some", Type::somekw},
+        {"subtype", Type::subtypekw},
+        {"sync", Type::synckw},
+        {"tagged", Type::taggedkw},
+        {"task", Type::taskkw},
+        {"terminate", Type::terminatekw},
+        {"then", Type::thenkw},
+        {"type", Type::typekw},
+        {"until", Type::untilkw},
+        {"use", Type::usekw},
+        {"when", Type::whenkw},
+        {"with", Type::withkw},
+        {"mod", Type::mod},
+        {"not", Type::notop},
+        {"in", Type::in},
+        {"is", Type::is},
+        {"and", Type::andop},
+        {"or", Type::orop},
+        {"xor", Type::xorop}
+    };
+
+    constexpr std::size_t MINLENGTH = 2;
+    constexpr std::size_t MAXLENGTH = 9;
+    constexpr unsigned int BITS = 8;
+    constexpr std::size_t SIZE = std::size_t(1) << BITS;
+
+    /// @brief Ключ из длины, первого и двух последних символов (длина не меньше MINLENGTH)
+    constexpr std::uint32_t key(std::string_view _id)
+    {
+        return std::uint32_t(_id.size())
+            | std::uint32_t(std::uint8_t(_id[0])) << 8
+            | std::uint32_t(std::uint8_t(_id[_id.size() - 2])) << 16
+            | std::uint32_t(std::uint8_t(_id[_id.size() - 1])) << 24;
+    }
+
+    constexpr bool lengths_fit()
+    {
+        for (const Keyword& kw : keywords)
+            if (kw.name.size() < MINLENGTH || kw.name.size() > MAXLENGTH)
+                return false;
+        return true;
+    }
+    static_assert(lengths_fit(), "keyword length is out of [MINLENGTH, MAXLENGTH]");
+
+    constexpr std::size_t slot(std::uint32_t _key, std::uint32_t _seed)
+    {
+        return std::uint32_t(_key * _seed) >> (32 - BITS);
+    }
+
+    constexpr bool perfect(std::uint32_t _seed)
+    {
+        bool used[SIZE] = {};
+        for (const Keyword& kw : keywords) {
+            std::size_t i = slot(key(kw.name), _seed);
+            if (used[i])
+                return false;
+            used[i] = true;
+        }
+        return true;
+    }
+
+    /// @brief Множитель подобран перебором так, чтобы у ключевых слов не было коллизий.
+    /// При изменении списка ключевых слов static_assert ниже подскажет подобрать новый
+    constexpr std::uint32_t SEED = 0x9E3A81A3u;
+    static_assert(perfect(SEED), "keyword hash has collisions, pick another SEED");
+
+    constexpr std::array<Keyword, SIZE> make_table()
+    {
+        std::array<Keyword, SIZE> table = {};
+        for (auto& entry : table)
+            entry = {std::string_view(), Type::id};
+        for (const Keyword& kw : keywords)
+            table[slot(key(kw.name), SEED)] = kw;
+        return table;
+    }
+
+    constexpr std::array<Keyword, SIZE> table = make_table();
+}
+
+Type recognize_keyword(std::string_view _id)
+{
+    if (_id.size() < MINLENGTH || _id.size() > MAXLENGTH)
+        return Type::id;
+    const Keyword& kw = table[slot(key(_id), SEED)];
+    return kw.name == _id ? kw.type : Type::id;
+}
@@ -1,148 +1,93 @@
 #include <axx/lexer/Lexer.hpp>
 #include <axx/lexer/LexerStates.hpp>
-#include <unordered_map>
+#include <axx/lexer/Keywords.hpp>
 #include <iostream>
-#define CHARCOUNT 1000
 
-Type Lexer::recognize(const std::string &_id) const
-{
-    static const std::unordered_map<std::string, Type> map = {
-        {"if", Type::ifkw},
-        {"elsif", Type::elsifkw},
-        {"else", Type::elsekw},
-        {"for", Type::forkw},
-        {"while", Type::whilekw},
-        {"return", Type::returnkw},
-        {"abort", Type::abortkw},
-        {"abs", Type::abskw},
-        {"abstract", Type::abstractkw},
-        {"accept", Type::acceptkw},
-        {"access", Type::accesskw},
-        {"aliased", Type::aliasedkw},
-        {"all", Type::allkw},
-        {"array", Type::arraykw},
-        {"at", Type::atkw},
-        {"begin", Type::beginkw},
-        {"body", Type::bodykw},
-        {"case", Type::casekw},
-        {"constant", Type::constantkw},
-        {"declare", Type::declarekw},
-        {"delay", Type::delaykw},
-        {"delta", Type::deltakw},
-        {"digits", Type::digitskw},
-        {"do", Type::dokw},
-        {"end", Type::endkw},
-        {"entry", Type::entrykw},
-        {"exception", Type::exceptionkw},
-        {"exit", Type::exitkw},
-        {"function", Type::functionkw},
-        {"generic", Type::generickw},
-        {"goto", Type::gotokw},
-        {"interface", Type::interfacekw},
-        {"limited", Type::limitedkw},
-        {"loop", Type::loopkw},
-        {"new", Type::newkw},
-        {"null", Type::nullkw},
-        {"of", Type::ofkw},
-        {"others", Type::otherskw},
-        {"out", Type::outkw},
-        {"overrid", Type::overridkw},
-        {"package", Type::packagekw},
-        {"pragma", Type::pragmakw},
-        {"private", Type::privatekw},
-        {"procedure", Type::procedurekw},
-        {"protected", Type::protectedkw},
-        {"raise", Type::raisekw},
-        {"range", Type::rangekw},
-        {"record", Type::recordkw},
-        {"rem", Type::remkw},
-        {"renames", Type::renameskw},
-        {"requeue", Type::requeuekw},
-        {"reverse", Type::reversekw},
-        {"select", Type::selectkw},
-        {"separate", Type::separatekw},
-        {"some", Type::somekw},
-        {"subtype", Type::subtypekw},
-        {"sync", Type::synckw},
-        {"tagged", Type::taggedkw},
-        {"task", Type::taskkw},
-        {"terminate", Type::terminatekw},
-        {"then", Type::thenkw},
-        {"type", Type::typekw},
-        {"until", Type::untilkw},
-        {"use", Type::usekw},
-        {"when", Type::whenkw},
-        {"while", Type::whilekw},
-        {"with", Type::withkw},
-        {"mod", Type::mod},
-        {"not", Type::notop},
-        {"in", Type::in},
-        {"is", Type::is},
-        {"and", Type::andop},
-        {"or", Type::orop},
-        {"xor", Type::xorop}
-};
-
-    if (map.find(_id) != map.end())
-        return map.at(_id);
-    else
-        return Type::id;
-}
+Lexer::Lexer(Interner &_interner) : interner(_interner) {}
 
 void Lexer::open(std::istream &_stream)
 {
     filedata.reset(new FileData());
-    currBuff.reset(new std::string(CHARCOUNT + 1, '\0'));
-    otherBuff.reset(new std::string());
-
-    this->stream = &_stream;
+    input.open(_stream);
+    filedata->input = &input;
+    filedata->lines = input.getLines();
+    filedata->cursor = input.iter;
+    setState(new Start(this, filedata.get()));
+}
 
-    this->stream->read(&(*currBuff)[0], CHARCOUNT);
-    iter = currBuff->cbegin();
+void Lexer::open(const std::string &_path)
+{
+    filedata.reset(new FileData());
+    input.open(std::make_shared<const SourceFile>(_path));
+    filedata->source = input.iter;
+    filedata->sourceSize = input.end - input.iter;
+    filedata->sourceId = input.getSource()->getId();
+    filedata->input = &input;
+    filedata->lines = input.getLines();
+    filedata->cursor = input.iter;
     setState(new Start(this, filedata.get()));
 }
 
+std::shared_ptr<const SourceFile> Lexer::getSource() const
+{
+    return input.getSource();
+}
+
 void Lexer::setState(LexerStateInterface *_state)
 {
     this->state.reset(_state);
 }
 
-Token Lexer::getToken()
+void Lexer::scan()
 {
-    while (filedata->queue.empty() && iter != currBuff->cend())
+    while (filedata->queue.empty() && input.iter != input.end)
     {
-        this->state->recognize(*iter++);
+        input.iter = this->state->fastforward(input.iter, input.end);
+        if (input.iter == input.end)
+            break;
+        filedata->cursor = input.iter;
+        this->state->recognize(*input.iter++);
     }
+}
 
-    Token tok = filedata->get();
+void Lexer::finish()
+{
+    // Файл закончился посреди лексемы: передаём состоянию завершающий '\0', как при чтении потока
+    filedata->cursor = input.end;
+    this->state->recognize('\0');
+    if (filedata->queue.empty())
+    {
+        filedata->discard();
+        filedata->put(Type::eof, filedata->offset(input.end));
+    }
+}
 
-    if (tok.getType() == Type::eof)
+Token Lexer::next()
+{
+    scan();
+    // Порция потока кончилась раньше лексемы: дочитываем поток, а в конце текста завершаем лексему
+    while (filedata->queue.empty() && input.refill())
     {
-        if (iter == currBuff->cend())
-        {
-            otherBuff->assign(CHARCOUNT + 1, '\0');
-            stream->read(&(*otherBuff)[0], CHARCOUNT);
-            iter = otherBuff->cbegin();
-            currBuff.swap(otherBuff);
-            while (filedata->queue.empty() && iter != currBuff->cend())
-            {
-                this->state->recognize(*iter++);
-            }
-            tok = filedata->get();
-            if (tok.getType() == Type::eof)
-            {
-                return tok;
-            }
-        }
-        else
-        {
-            return tok;
-        }
+        scan();
     }
+    if (filedata->queue.empty())
+    {
+        finish();
+    }
+    return filedata->get();
+}
+
+Token Lexer::getToken()
+{
+    Token tok = next();
 
     if (tok.getType() == Type::id)
     {
-        tok.setType(recognize(tok.getValue()));
+        tok.setType(recognize_keyword(tok.getValue()));
+        if (tok.getType() == Type::id)
+        {
+            interner.attach(tok);
+        }
     }
     return tok;
 }
@@ -1,5 +1,6 @@
 #include <axx/lexer/LexerStates.hpp>
 #include <axx/lexer/FileData.hpp>
+#include <axx/lexer/Scan.hpp>
 #include <unordered_map>
 #include <functional>
 #include <unordered_set>
@@ -36,7 +37,6 @@ fac(Lpr)
 fac(Rpr)
 fac(Comma)
 fac(Skip)
-fac(Newline)
 
 static std::unordered_map<char, stateFactory_t> table = {
     tab('&', Ampersand),
@@ -55,24 +55,29 @@ static std::unordered_map<char, stateFactory_t> table = {
     tab(':', Colon),
     tab(';', Semicolon),
     tab('"', String),
-    tab('\'', Character),
-    tab('\n', Newline)
+    tab('\'', Character)
 };
 
 static const std::unordered_set<char> symbols = {
-    '+', '-', '*', '/', '&', '|', '<', '>', '=', '.', ',', '(', ')', ':', ';', '\'', '"', '\n'};
+    '+', '-', '*', '/', '&', '|', '<', '>', '=', '.', ',', '(', ')', ':', ';', '\'', '"'};
+
+// Классы символов только ASCII, как в TableLexer и Scan: от локали разбор не зависит
+static inline bool isDigit(char _c)
+{
+    return _c >= '0' && _c <= '9';
+}
 
 static inline bool isSuitableForIdBeginning(char _c)
 {
-    return std::isalpha(_c);
+    return (_c >= 'a' && _c <= 'z') || (_c >= 'A' && _c <= 'Z');
 }
 
 static inline bool isSuitableForId(char _c)
 {
-    return std::isalnum(_c) || _c == '_';
+    return isSuitableForIdBeginning(_c) || isDigit(_c) || _c == '_';
 }
 
-BaseLexerState::BaseLexerState(LexerInterface *_lex, FileData *_filedata) : lexer(_lex), filedata(_filedata), initpos(_filedata->pos) {}
+BaseLexerState::BaseLexerState(LexerInterface *_lex, FileData *_filedata) : lexer(_lex), filedata(_filedata), initpos(_filedata->offset(_filedata->cursor)) {}
 
 static stateFactory_t tablestate(char _c)
 {
@@ -92,12 +97,12 @@ impl(Start)
 {
     if (isSuitableForIdBeginning(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(Id);
     }
-    else if (std::isdigit(_c))
+    else if (isDigit(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(FirstNumPart);
     }
     else if (_c != '\n')
@@ -110,7 +115,7 @@ impl(Start)
         }
         else
         {
-            filedata->put(Type::eof, filedata->row, initpos);
+            filedata->put(Type::eof, initpos);
         }
     }
     return false;
@@ -118,15 +123,14 @@ impl(Start)
 
 impl(Skip)
 {
-    filedata->pos++;
     if (isSuitableForIdBeginning(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(Id);
     }
-    else if (std::isdigit(_c))
+    else if (isDigit(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(FirstNumPart);
     }
     else
@@ -139,20 +143,30 @@ impl(Skip)
         }
         else
         {
-            filedata->put(Type::eof, filedata->row, initpos);
+            filedata->put(Type::eof, initpos);
         }
     }
     return false;
 }
 
+const char* Skip::fastforward(const char* _begin, const char* _end)
+{
+    // Каждый пробел перевёл бы Skip в новый Skip с initpos на этом пробеле
+    const char* p = skip_blanks(_begin, _end);
+    if (p != _begin)
+    {
+        initpos = filedata->offset(p - 1);
+    }
+    return p;
+}
+
 impl(Id)
 {
-    filedata->pos++;
     if (isSuitableForId(_c))
     {
         if (_c == '_' && hasUnderscore)
         {
-            filedata->put(Type::unexpected, filedata->row, filedata->pos);
+            filedata->put(Type::unexpected, filedata->offset(filedata->cursor));
             return false;
         }
         else if (_c == '_' && !hasUnderscore)
@@ -163,11 +177,11 @@ impl(Id)
         {
             hasUnderscore = false;
         }
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
     }
     else
     {
-        filedata->put(Type::id, filedata->row, initpos);
+        filedata->put(Type::id, initpos);
         auto p = tablestate(_c);
         ;
         if (p)
@@ -176,62 +190,70 @@ impl(Id)
         }
         else
         {
-            filedata->put(Type::eof, filedata->row, initpos);
+            filedata->put(Type::eof, initpos);
         }
     }
     return false;
 }
 
+const char* Id::fastforward(const char* _begin, const char* _end)
+{
+    const char* p = skip_alnum(_begin, _end);
+    if (p != _begin)
+    {
+        filedata->push(_begin, p - _begin);
+        hasUnderscore = false;
+    }
+    return p;
+}
+
 impl(String)
 {
-    filedata->pos++;
     if (_c == '"')
     {
-        filedata->put(Type::string, filedata->row, initpos);
+        filedata->put(Type::string, initpos);
         newstate(Skip);
     }
     else
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
     }
     return false;
 }
 
 impl(Character)
 {
-    filedata->pos++;
-    filedata->accum.push_back(_c);
+    filedata->push(_c);
     if (_c == '\'')
     {
-        filedata->put(Type::character, filedata->row, initpos);
+        filedata->put(Type::character, initpos);
         newstate(Skip);
     }
     else
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
     }
     return false;
 }
 
 impl(Colon)
 {
-    filedata->pos++;
     if (_c == '=')
     {
-        filedata->put(Type::assign, filedata->row, initpos);
+        filedata->put(Type::assign, initpos);
         newstate(Skip);
     }
     else
     {
-        filedata->put(Type::colon, filedata->row, initpos);
+        filedata->put(Type::colon, initpos);
         if (isSuitableForIdBeginning(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(Id);
         }
-        else if (std::isdigit(_c))
+        else if (isDigit(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(FirstNumPart);
         }
         else
@@ -244,7 +266,7 @@ impl(Colon)
             }
             else
             {
-                filedata->put(Type::eof, filedata->row, initpos);
+                filedata->put(Type::eof, initpos);
             }
         }
     }
@@ -253,16 +275,15 @@ impl(Colon)
 
 impl(Semicolon)
 {
-    filedata->pos++;
-    filedata->put(Type::semicolon, filedata->row, initpos);
+    filedata->put(Type::semicolon, initpos);
     if (isSuitableForIdBeginning(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(Id);
     }
-    else if (std::isdigit(_c))
+    else if (isDigit(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(FirstNumPart);
     }
     else
@@ -275,7 +296,7 @@ impl(Semicolon)
         }
         else
         {
-            filedata->put(Type::eof, filedata->row, initpos);
+            filedata->put(Type::eof, initpos);
         }
     }
     return false;
@@ -283,16 +304,15 @@ impl(Semicolon)
 
 impl(Ampersand)
 {
-    filedata->pos++;
-    filedata->put(Type::ampersand, filedata->row, initpos);
+    filedata->put(Type::ampersand, initpos);
     if (isSuitableForIdBeginning(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(Id);
     }
-    else if (std::isdigit(_c))
+    else if (isDigit(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(FirstNumPart);
     }
     else
@@ -305,7 +325,7 @@ impl(Ampersand)
         }
         else
         {
-            filedata->put(Type::eof, filedata->row, initpos);
+            filedata->put(Type::eof, initpos);
         }
     }
     return false;
@@ -313,16 +333,15 @@ impl(Ampersand)
 
 impl(VerticalLine)
 {
-    filedata->pos++;
-    filedata->put(Type::vertical, filedata->row, initpos);
+    filedata->put(Type::vertical, initpos);
     if (isSuitableForIdBeginning(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(Id);
     }
-    else if (std::isdigit(_c))
+    else if (isDigit(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(FirstNumPart);
     }
     else
@@ -335,7 +354,7 @@ impl(VerticalLine)
         }
         else
         {
-            filedata->put(Type::eof, filedata->row, initpos);
+            filedata->put(Type::eof, initpos);
         }
     }
     return false;
@@ -343,23 +362,22 @@ impl(VerticalLine)
 
 impl(Dot)
 {
-    filedata->pos++;
     if (_c == '.')
     {
-        filedata->put(Type::doubledot, filedata->row, initpos);
+        filedata->put(Type::doubledot, initpos);
         newstate(Skip);
     }
     else
     {
-        filedata->put(Type::dot, filedata->row, initpos);
+        filedata->put(Type::dot, initpos);
         if (isSuitableForIdBeginning(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(Id);
         }
-        else if (std::isdigit(_c))
+        else if (isDigit(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(FirstNumPart);
         }
         else
@@ -372,7 +390,7 @@ impl(Dot)
             }
             else
             {
-                filedata->put(Type::eof, filedata->row, initpos);
+                filedata->put(Type::eof, initpos);
             }
         }
     }
@@ -381,10 +399,9 @@ impl(Dot)
 
 impl(FirstNumPart)
 {
-    filedata->pos++;
-    if (std::isdigit(_c))
+    if (isDigit(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
     }
     else if (_c == '.')
     {
@@ -392,10 +409,10 @@ impl(FirstNumPart)
     }
     else
     {
-        filedata->put(Type::number, filedata->row, initpos);
+        filedata->put(Type::number, initpos);
         if (isSuitableForIdBeginning(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(Id);
         }
         else
@@ -408,33 +425,32 @@ impl(FirstNumPart)
             }
             else
             {
-                filedata->put(Type::eof, filedata->row, initpos);
+                filedata->put(Type::eof, initpos);
             }
         }
     }
     return false;
 }
 
-SecondNumPart::SecondNumPart(LexerInterface *_lex, FileData *_filedata, unsigned int _initpos) : BaseLexerState(_lex, _filedata)
+SecondNumPart::SecondNumPart(LexerInterface *_lex, FileData *_filedata, std::uint32_t _initpos) : BaseLexerState(_lex, _filedata)
 {
     initpos = _initpos;
 }
 bool SecondNumPart::recognize(char _c)
 {
-    filedata->pos++;
-    if (std::isdigit(_c))
+    if (isDigit(_c))
     {
         if (created)
         {
-            filedata->accum.push_back('.');
+            filedata->push('.');
             created = false;
         }
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
     }
     else
     {
-        filedata->put(Type::number, filedata->row, initpos);
-        filedata->put(Type::dot, filedata->row, filedata->pos);
+        filedata->put(Type::number, initpos);
+        filedata->put(Type::dot, filedata->offset(filedata->cursor));
         auto p = tablestate(_c);
         ;
         if (p)
@@ -443,7 +459,7 @@ bool SecondNumPart::recognize(char _c)
         }
         else
         {
-            filedata->put(Type::eof, filedata->row, initpos);
+            filedata->put(Type::eof, initpos);
         }
     }
     return false;
@@ -451,16 +467,15 @@ bool SecondNumPart::recognize(char _c)
 
 impl(Plus)
 {
-    filedata->pos++;
-    filedata->put(Type::plus, filedata->row, initpos);
+    filedata->put(Type::plus, initpos);
     if (isSuitableForIdBeginning(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(Id);
     }
-    else if (std::isdigit(_c))
+    else if (isDigit(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(FirstNumPart);
     }
     else
@@ -473,7 +488,7 @@ impl(Plus)
         }
         else
         {
-            filedata->put(Type::eof, filedata->row, initpos);
+            filedata->put(Type::eof, initpos);
         }
     }
     return false;
@@ -481,22 +496,21 @@ impl(Plus)
 
 impl(Minus)
 {
-    filedata->pos++;
     if (_c == '-')
     {
         newstate(Comment);
     }
     else
     {
-        filedata->put(Type::minus, filedata->row, initpos);
+        filedata->put(Type::minus, initpos);
         if (isSuitableForIdBeginning(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(Id);
         }
-        else if (std::isdigit(_c))
+        else if (isDigit(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(FirstNumPart);
         }
         else
@@ -509,7 +523,7 @@ impl(Minus)
             }
             else
             {
-                filedata->put(Type::eof, filedata->row, initpos);
+                filedata->put(Type::eof, initpos);
             }
         }
     }
@@ -518,23 +532,22 @@ impl(Minus)
 
 impl(Star)
 {
-    filedata->pos++;
     if (_c == '*')
     {
-        filedata->put(Type::power, filedata->row, initpos);
+        filedata->put(Type::power, initpos);
         newstate(Skip);
     }
     else
     {
-        filedata->put(Type::star, filedata->row, initpos);
+        filedata->put(Type::star, initpos);
         if (isSuitableForIdBeginning(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(Id);
         }
-        else if (std::isdigit(_c))
+        else if (isDigit(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(FirstNumPart);
         }
         else
@@ -547,7 +560,7 @@ impl(Star)
             }
             else
             {
-                filedata->put(Type::eof, filedata->row, initpos);
+                filedata->put(Type::eof, initpos);
             }
         }
     }
@@ -556,23 +569,22 @@ impl(Star)
 
 impl(Div)
 {
-    filedata->pos++;
     if (_c == '=')
     {
-        filedata->put(Type::noteq, filedata->row, initpos);
+        filedata->put(Type::noteq, initpos);
         newstate(Skip);
     }
     else
     {
-        filedata->put(Type::div, filedata->row, initpos);
+        filedata->put(Type::div, initpos);
         if (isSuitableForIdBeginning(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(Id);
         }
-        else if (std::isdigit(_c))
+        else if (isDigit(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(FirstNumPart);
         }
         else
@@ -585,7 +597,7 @@ impl(Div)
             }
             else
             {
-                filedata->put(Type::eof, filedata->row, initpos);
+                filedata->put(Type::eof, initpos);
             }
         }
     }
@@ -594,28 +606,27 @@ impl(Div)
 
 impl(Greater)
 {
-    filedata->pos++;
     if (_c == '=')
     {
-        filedata->put(Type::grequal, filedata->row, initpos);
+        filedata->put(Type::grequal, initpos);
         newstate(Skip);
     }
     else if (_c == '>')
     {
-        filedata->put(Type::rlabbr, filedata->row, initpos);
+        filedata->put(Type::rlabbr, initpos);
         newstate(Skip);
     }
     else
     {
-        filedata->put(Type::greater, filedata->row, initpos);
+        filedata->put(Type::greater, initpos);
         if (isSuitableForIdBeginning(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(Id);
         }
-        else if (std::isdigit(_c))
+        else if (isDigit(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(FirstNumPart);
         }
         else
@@ -628,7 +639,7 @@ impl(Greater)
             }
             else
             {
-                filedata->put(Type::eof, filedata->row, initpos);
+                filedata->put(Type::eof, initpos);
             }
         }
     }
@@ -637,33 +648,32 @@ impl(Greater)
 
 impl(Less)
 {
-    filedata->pos++;
     if (_c == '=')
     {
-        filedata->put(Type::lequal, filedata->row, initpos);
+        filedata->put(Type::lequal, initpos);
         newstate(Skip);
     }
     else if (_c == '<')
     {
-        filedata->put(Type::llabbr, filedata->row, initpos);
+        filedata->put(Type::llabbr, initpos);
         newstate(Skip);
     }
     else if (_c == '>')
     {
-        filedata->put(Type::box, filedata->row, initpos);
+        filedata->put(Type::box, initpos);
         newstate(Skip);
     }
     else
     {
-        filedata->put(Type::less, filedata->row, initpos);
+        filedata->put(Type::less, initpos);
         if (isSuitableForIdBeginning(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(Id);
         }
-        else if (std::isdigit(_c))
+        else if (isDigit(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(FirstNumPart);
         }
         else
@@ -676,7 +686,7 @@ impl(Less)
             }
             else
             {
-                filedata->put(Type::eof, filedata->row, initpos);
+                filedata->put(Type::eof, initpos);
             }
         }
     }
@@ -685,23 +695,22 @@ impl(Less)
 
 impl(Equal)
 {
-    filedata->pos++;
     if (_c == '>')
     {
-        filedata->put(Type::arrow, filedata->row, initpos);
+        filedata->put(Type::arrow, initpos);
         newstate(Skip);
     }
     else
     {
-        filedata->put(Type::equal, filedata->row, initpos);
+        filedata->put(Type::equal, initpos);
         if (isSuitableForIdBeginning(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(Id);
         }
-        else if (std::isdigit(_c))
+        else if (isDigit(_c))
         {
-            filedata->accum.push_back(_c);
+            filedata->push(_c);
             newstate(FirstNumPart);
         }
         else
@@ -714,7 +723,7 @@ impl(Equal)
             }
             else
             {
-                filedata->put(Type::eof, filedata->row, initpos);
+                filedata->put(Type::eof, initpos);
             }
         }
     }
@@ -723,16 +732,15 @@ impl(Equal)
 
 impl(Lpr)
 {
-    filedata->pos++;
-    filedata->put(Type::lpr, filedata->row, initpos);
+    filedata->put(Type::lpr, initpos);
     if (isSuitableForIdBeginning(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(Id);
     }
-    else if (std::isdigit(_c))
+    else if (isDigit(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(FirstNumPart);
     }
     else
@@ -745,7 +753,7 @@ impl(Lpr)
         }
         else
         {
-            filedata->put(Type::eof, filedata->row, initpos);
+            filedata->put(Type::eof, initpos);
         }
     }
     return false;
@@ -753,16 +761,15 @@ impl(Lpr)
 
 impl(Rpr)
 {
-    filedata->pos++;
-    filedata->put(Type::rpr, filedata->row, initpos);
+    filedata->put(Type::rpr, initpos);
     if (isSuitableForIdBeginning(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(Id);
     }
-    else if (std::isdigit(_c))
+    else if (isDigit(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(FirstNumPart);
     }
     else
@@ -775,7 +782,7 @@ impl(Rpr)
         }
         else
         {
-            filedata->put(Type::eof, filedata->row, initpos);
+            filedata->put(Type::eof, initpos);
         }
     }
     return false;
@@ -785,53 +792,27 @@ impl(Comment)
 {
     if (_c == '\n')
     {
-        newstate(Newline);
+        newstate(Skip);
     }
     return false;
 }
 
-impl(Comma)
+const char* Comment::fastforward(const char* _begin, const char* _end)
 {
-    filedata->pos++;
-    filedata->put(Type::comma, filedata->row, initpos);
-    if (isSuitableForIdBeginning(_c))
-    {
-        filedata->accum.push_back(_c);
-        newstate(Id);
-    }
-    else if (std::isdigit(_c))
-    {
-        filedata->accum.push_back(_c);
-        newstate(FirstNumPart);
-    }
-    else
-    {
-        auto p = tablestate(_c);
-        ;
-        if (p)
-        {
-            lexer->setState(p(lexer, filedata));
-        }
-        else
-        {
-            filedata->put(Type::eof, filedata->row, initpos);
-        }
-    }
-    return false;
+    return find_newline(_begin, _end);
 }
 
-impl(Newline)
+impl(Comma)
 {
-    filedata->pos = 1;
-    filedata->row++;
+    filedata->put(Type::comma, initpos);
     if (isSuitableForIdBeginning(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(Id);
     }
-    else if (std::isdigit(_c))
+    else if (isDigit(_c))
     {
-        filedata->accum.push_back(_c);
+        filedata->push(_c);
         newstate(FirstNumPart);
     }
     else
@@ -844,7 +825,7 @@ impl(Newline)
         }
         else
         {
-            filedata->put(Type::eof, filedata->row, initpos);
+            filedata->put(Type::eof, initpos);
         }
     }
     return false;
@@ -0,0 +1,104 @@
+#include <axx/token/LineIndex.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+#define INDEXCOUNT 65536
+
+namespace
+{
+    std::atomic<const LineIndex*> indexes[INDEXCOUNT];
+    std::atomic<std::uint16_t> generations[INDEXCOUNT];
+    std::mutex mutex;
+    std::vector<std::uint16_t> freeIds;
+    unsigned int nextId = 1;
+
+    std::uint16_t allocateId(const LineIndex* _index)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::uint16_t id;
+        if (!freeIds.empty())
+        {
+            id = freeIds.back();
+            freeIds.pop_back();
+        }
+        else if (nextId < INDEXCOUNT)
+        {
+            id = static_cast<std::uint16_t>(nextId++);
+        }
+        else
+        {
+            throw std::runtime_error("Too many line indexes");
+        }
+        indexes[id].store(_index, std::memory_order_release);
+        return id;
+    }
+}
+
+LineIndex::LineIndex(const char* _data, std::size_t _size) : data(_data), size(_size), starts(1, 0)
+{
+    id = allocateId(this);
+}
+
+LineIndex::LineIndex() : data(nullptr), size(0), starts(1, 0)
+{
+    // У потока строить нечего: начала строк приходят через feed
+    std::call_once(built, [] {});
+    id = allocateId(this);
+}
+
+LineIndex::~LineIndex()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    indexes[id].store(nullptr, std::memory_order_release);
+    generations[id].fetch_add(1, std::memory_order_release);
+    freeIds.push_back(id);
+}
+
+void LineIndex::build() const
+{
+    const char* p = data;
+    const char* end = data + size;
+    while (p != end)
+    {
+        const void* eol = std::memchr(p, '\n', end - p);
+        if (!eol)
+            break;
+        p = static_cast<const char*>(eol) + 1;
+        starts.push_back(static_cast<std::uint32_t>(p - data));
+    }
+}
+
+void LineIndex::feed(const char* _begin, std::size_t _count, std::uint32_t _offset)
+{
+    for (std::size_t i = 0; i < _count; i++)
+    {
+        if (_begin[i] == '\n')
+            starts.push_back(_offset + static_cast<std::uint32_t>(i) + 1);
+    }
+}
+
+void LineIndex::resolve(std::uint32_t _offset, unsigned int& _row, unsigned int& _pos) const
+{
+    std::call_once(built, [this] { build(); });
+    // Последнее начало строки, не превосходящее _offset
+    auto line = std::upper_bound(starts.begin(), starts.end(), _offset) - 1;
+    _row = static_cast<unsigned int>(line - starts.begin()) + 1;
+    _pos = _offset - *line + 1;
+}
+
+std::uint16_t LineIndex::getId() const
+{
+    return id;
+}
+
+const LineIndex* LineIndex::find(std::uint16_t _id)
+{
+    return indexes[_id].load(std::memory_order_acquire);
+}
+
+std::uint16_t LineIndex::generation(std::uint16_t _id)
+{
+    return generations[_id].load(std::memory_order_acquire);
+}
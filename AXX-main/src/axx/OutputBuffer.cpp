@@ -0,0 +1,42 @@
+#include <axx/codegen/OutputBuffer.hpp>
+
+OutputBuffer::OutputBuffer() : stream(nullptr) {}
+
+OutputBuffer::OutputBuffer(std::ostream& _stream) : stream(&_stream)
+{
+    buffer.reserve(CAPACITY);
+}
+
+OutputBuffer::~OutputBuffer()
+{
+    flush();
+}
+
+void OutputBuffer::append(std::string_view _text)
+{
+    if (stream && buffer.size() + _text.size() > CAPACITY)
+    {
+        flush();
+        // Фрагмент больше буфера копировать незачем
+        if (_text.size() > CAPACITY)
+        {
+            stream->write(_text.data(), _text.size());
+            return;
+        }
+    }
+    buffer.append(_text);
+}
+
+void OutputBuffer::flush()
+{
+    if (!stream)
+        return;
+    stream->write(buffer.data(), buffer.size());
+    stream->flush();
+    buffer.clear();
+}
+
+std::string_view OutputBuffer::text() const
+{
+    return buffer;
+}
@@ -0,0 +1,168 @@
+#include <axx/lexer/ParallelLexer.hpp>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <thread>
+
+// Участок меньше этого размера не стоит отдельного потока
+#define MINCHUNK (1 << 20)
+
+namespace
+{
+    struct Chunk
+    {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    // Делит файл на _count участков примерно равной длины. Граница ставится только на перевод строки,
+    // до которого автомат TableLexer не находится в строковом или символьном литерале: литералы в нём
+    // продолжаются через переводы строк. Комментарий заканчивается переводом строки, так что после него
+    // граница допустима. Файл просматривается упрощённым автоматом, который лишь пропускает литералы и комментарии
+    std::vector<Chunk> split(const char* _data, std::size_t _size, std::size_t _count)
+    {
+        std::vector<Chunk> chunks;
+        std::size_t begin = 0;
+        std::size_t target = _size / _count;
+
+        // Переводы строк в начале файла автомат пропускает в состоянии start, а не skip
+        std::size_t i = 0;
+        while (i < _size && _data[i] == '\n')
+            i++;
+
+        while (i < _size && chunks.size() + 1 < _count)
+        {
+            const char c = _data[i];
+            if (c == '\n')
+            {
+                if (i >= target)
+                {
+                    chunks.push_back({begin, i});
+                    begin = i;
+                    target = _size / _count * (chunks.size() + 1);
+                }
+                i++;
+            }
+            else if (c == '"' || c == '\'')
+            {
+                const void* close = std::memchr(_data + i + 1, c, _size - i - 1);
+                if (!close)
+                    break;
+                i = static_cast<const char*>(close) - _data + 1;
+            }
+            else if (c == '-' && i + 1 < _size && _data[i + 1] == '-')
+            {
+                const void* eol = std::memchr(_data + i + 2, '\n', _size - i - 2);
+                if (!eol)
+                    break;
+                i = static_cast<const char*>(eol) - _data;
+            }
+            else if (c == '\0')
+            {
+                // Вне литералов '\0' завершает разбор, остаток файла достаётся последнему участку
+                break;
+            }
+            else
+            {
+                i++;
+            }
+        }
+        chunks.push_back({begin, _size});
+        return chunks;
+    }
+}
+
+ParallelLexer::ParallelLexer(Interner &_interner, unsigned int _threads) : interner(_interner), threads(_threads), current(0)
+{
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+}
+
+void ParallelLexer::open(std::istream &_stream)
+{
+    source.reset();
+    tokens.clear();
+    current = 0;
+    sequential.reset(new TableLexer(interner));
+    sequential->open(_stream);
+}
+
+void ParallelLexer::open(const std::string &_path)
+{
+    sequential.reset();
+    tokens.clear();
+    current = 0;
+    source = std::make_shared<const SourceFile>(_path);
+
+    std::size_t count = source->getSize() / MINCHUNK;
+    if (count > threads)
+        count = threads;
+    if (count <= 1)
+    {
+        // Делить нечего: токены выдаются сразу, без промежуточного вектора
+        sequential.reset(new TableLexer(interner));
+        sequential->open(source, 0, source->getSize());
+        return;
+    }
+
+    std::vector<std::future<std::vector<Token>>> parts;
+    for (const Chunk &chunk : split(source->getData(), source->getSize(), count))
+    {
+        parts.push_back(std::async(std::launch::async, [this, chunk]() {
+            TableLexer lexer(interner);
+            lexer.open(source, chunk.begin, chunk.end);
+            std::vector<Token> part;
+            lexer.tokenize(part);
+            return part;
+        }));
+    }
+
+    for (std::size_t i = 0; i < parts.size(); i++)
+    {
+        std::vector<Token> part = parts[i].get();
+        // eof участка, кроме последнего, отмечает границу, а не конец файла
+        if (i + 1 < parts.size())
+            part.pop_back();
+        if (tokens.empty())
+            tokens.swap(part);
+        else
+            tokens.insert(tokens.end(), part.begin(), part.end());
+    }
+}
+
+std::shared_ptr<const SourceFile> ParallelLexer::getSource() const
+{
+    return sequential ? sequential->getSource() : source;
+}
+
+void ParallelLexer::setState(LexerStateInterface *_state)
+{
+    // Объекты состояний параллельному лексеру не нужны
+    delete _state;
+}
+
+Token ParallelLexer::getToken()
+{
+    if (sequential)
+        return sequential->getToken();
+
+    // Последний токен - eof, он выдаётся повторно, как у последовательных лексеров
+    Token tok = tokens[current];
+    if (current + 1 < tokens.size())
+        current++;
+    if (tok.getType() == Type::id)
+    {
+        interner.attach(tok);
+    }
+    return tok;
+}
+
+void ParallelLexer::print_all_tokens() {
+    Token token("", Type::id);
+    while ((token = this->getToken()).getType() != Type::eof) {
+        std::cout << type_to_str(token.getType()) << " " << token.getValue() << "\n";
+    }
+    std::cout << type_to_str(token.getType()) << " " << token.getValue() << "\n";
+}
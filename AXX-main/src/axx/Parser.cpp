@@ -2,63 +2,98 @@
 #include <axx/token/Token.hpp>
 #include <axx/AST/ASTNode.hpp>
 #include <axx/AST/AST.hpp>
-#include <stdexcept>
-#include <iostream>
-#include <map>
-#include <set>
-
-// Первые терминалы, которые можно встретить, переходя вглубь нетерминалов грамматики
-std::map<std::string, std::set<Type>> FIRSTS = {
-    {"procedure_declaration", {Type::procedurekw}},
-    {"nested_stmt", {Type::lpr, Type::whilekw, Type::plus, Type::ifkw, Type::minus, Type::id, Type::number, Type::forkw, Type::notop, Type::string, Type::returnkw}},
-    {"block", {Type::lpr, Type::whilekw, Type::plus, Type::ifkw, Type::minus, Type::id, Type::number, Type::forkw, Type::notop, Type::string, Type::returnkw}},
-    {"compound_stmt", {Type::ifkw, Type::whilekw, Type::forkw}},
-    {"term", {Type::lpr, Type::plus, Type::minus, Type::id, Type::number, Type::string}},
-    {"conjunction", {Type::lpr, Type::plus, Type::minus, Type::id, Type::number, Type::notop, Type::string}},
-    {"variable_declaration", {Type::id}},
-    {"if_stmt", {Type::ifkw}},
-    {"primary", {Type::lpr, Type::id, Type::number, Type::string}},
-    {"sum", {Type::lpr, Type::plus, Type::minus, Type::id, Type::number, Type::string}},
-    {"function_declaration", {Type::functionkw}},
-    {"expression", {Type::lpr, Type::plus, Type::minus, Type::id, Type::number, Type::notop, Type::string}},
-    {"comparison", {Type::lpr, Type::plus, Type::minus, Type::id, Type::number, Type::string}},
-    {"return_stmt", {Type::returnkw}},
-    {"while_stmt", {Type::whilekw}},
-    {"statement", {Type::lpr, Type::whilekw, Type::plus, Type::procedurekw, Type::ifkw, Type::minus, Type::functionkw, Type::id, Type::number, Type::forkw, Type::notop, Type::string, Type::returnkw}},
-    {"simple_stmt", {Type::lpr, Type::plus, Type::minus, Type::id, Type::number, Type::notop, Type::string, Type::returnkw}},
-    {"inversion", {Type::lpr, Type::plus, Type::minus, Type::id, Type::number, Type::notop, Type::string}},
-    {"variable_declarations", {Type::id}},
-    {"actual_params", {Type::lpr, Type::plus, Type::minus, Type::id, Type::number, Type::notop, Type::string}},
-    {"root_stmt", {Type::functionkw, Type::procedurekw}},
-    {"for_stmt", {Type::forkw}},
-    {"program", {Type::lpr, Type::whilekw, Type::plus, Type::procedurekw, Type::ifkw, Type::minus, Type::functionkw, Type::id, Type::number, Type::forkw, Type::eof, Type::notop, Type::string, Type::returnkw}},
-    {"else_block", {Type::elsekw}},
-    {"elsif_stmt", {Type::elsifkw}},
-    {"formal_params", {Type::id}},
-    {"disjunction", {Type::lpr, Type::plus, Type::minus, Type::id, Type::number, Type::notop, Type::string}},
-    {"func_call", {Type::lpr}},
-    {"atom", {Type::id, Type::number, Type::string}},
-    {"assignment", {Type::id}},
-    {"factor", {Type::lpr, Type::plus, Type::minus, Type::id, Type::number, Type::string}},
-    {"statements", {Type::lpr, Type::whilekw, Type::plus, Type::procedurekw, Type::ifkw, Type::minus, Type::functionkw, Type::id, Type::number, Type::forkw, Type::notop, Type::string, Type::returnkw}}};
-
-Parser::Parser() : token(Token("", Type::id)){};
+#include <axx/parser/Firsts.hpp>
+#include <array>
+#include <string>
+
+// Сила связывания бинарных операторов, 0 - токен не является бинарным оператором
+constexpr int OR_POWER = 1;
+constexpr int AND_POWER = 2;
+constexpr int COMPARISON_POWER = 3;
+constexpr int SUM_POWER = 4;
+constexpr int TERM_POWER = 5;
+constexpr int PREFIX_POWER = 6; // Операнд унарного плюса и минуса не содержит бинарных операторов
+
+constexpr std::array<std::uint8_t, static_cast<std::size_t>(Type::unexpected) + 1> make_binding_powers()
+{
+    std::array<std::uint8_t, static_cast<std::size_t>(Type::unexpected) + 1> powers = {};
+    powers[static_cast<std::size_t>(Type::orop)] = OR_POWER;
+    powers[static_cast<std::size_t>(Type::andop)] = AND_POWER;
+    for (Type type : {Type::greater, Type::less, Type::equal, Type::noteq, Type::grequal, Type::lequal})
+        powers[static_cast<std::size_t>(type)] = COMPARISON_POWER;
+    for (Type type : {Type::plus, Type::minus})
+        powers[static_cast<std::size_t>(type)] = SUM_POWER;
+    for (Type type : {Type::star, Type::div, Type::mod})
+        powers[static_cast<std::size_t>(type)] = TERM_POWER;
+    return powers;
+}
+
+constexpr auto BINDING_POWER = make_binding_powers();
+
+namespace
+{
+    // Бросается после записи синтаксической ошибки и ловится там, где разбор можно продолжить
+    struct SyntaxError {};
+}
+
+Parser::Parser(Diagnostics& _diagnostics) : token(Token("", Type::id)), finished(false), diagnostics(_diagnostics){};
 
 void Parser::setLexer(LexerInterface *lexer)
 {
     this->lexer = lexer;
+    this->future_tokens.clear();
+    this->finished = false;
     this->next_token();
 }
 
 AST *Parser::getAST()
 {
-    return new AST(this->program());
+    // Узлы нового дерева создаются в отдельной области, которую забирает AST
+    this->arena = std::make_unique<ASTArena>();
+    BaseASTNode *root = this->program();
+    return new AST(root, this->lexer->getSource(), std::move(this->arena));
+}
+
+AST *Parser::getNextStatement()
+{
+    // Каждая инструкция получает свою область памяти: после обработки дерево освобождается целиком,
+    // и расход памяти определяется самой большой подпрограммой, а не всем файлом
+    if (this->finished)
+    {
+        return nullptr;
+    }
+    while (true)
+    {
+        this->arena = std::make_unique<ASTArena>();
+        if (this->is_token_in_firsts(Rule::statements))
+        {
+            BlockNode *holder = this->arena->make<BlockNode>();
+            this->statement(holder);
+            // Инструкция с синтаксической ошибкой отброшена, берём следующую
+            if (!holder->children.empty())
+            {
+                return new AST(holder->children.front(), this->lexer->getSource(), std::move(this->arena));
+            }
+        }
+        else if (this->token_matches(Type::eof))
+        {
+            BaseASTNode *root = this->arena->make<Leaf>(this->check_get_next(Type::eof));
+            this->finished = true;
+            return new AST(root, this->lexer->getSource(), std::move(this->arena));
+        }
+        else
+        {
+            this->report("Unexpected token");
+            this->next_token();
+            this->skip_to_subprogram();
+        }
+    }
 }
 
-bool Parser::is_token_in_firsts(std::string grammar_node)
+bool Parser::is_token_in_firsts(Rule grammar_node)
 {
     // Возвращает True, если текущий токен кода можно получить, спускаясь по узлу грамматика grammar_node
-    return FIRSTS[grammar_node].find(this->token.getType()) != FIRSTS[grammar_node].end();
+    return FIRSTS[static_cast<std::size_t>(grammar_node)].contains(this->token.getType());
 }
 
 bool Parser::token_matches_any(std::vector<Type> types)
@@ -80,15 +115,53 @@ bool Parser::token_matches(Type type)
     return this->get_token().getType() == type;
 }
 
-void Parser::error(std::string message)
+void Parser::report(const char *context)
+{
+    // Ошибка на том же токене, что и предыдущая, - следствие восстановления, а не новая ошибка
+    auto &all = this->diagnostics.all();
+    if (!all.empty() && all.back().problem == Problem::Syntax && all.back().token.getPlace() == this->token.getPlace())
+    {
+        return;
+    }
+    this->diagnostics.report({Severity::Error, Problem::Syntax, this->token, this->token, context});
+}
+
+void Parser::error(const char *context)
+{
+    this->report(context);
+    throw SyntaxError();
+}
+
+void Parser::synchronize()
+{
+    // Восстановление в режиме паники: пропускаем токены до конца инструкции. Точка с запятой
+    // забирается, а end, begin, elsif и else остаются охватывающей конструкции
+    while (true)
+    {
+        switch (this->token.getType())
+        {
+        case Type::semicolon:
+            this->next_token();
+            return;
+        case Type::endkw:
+        case Type::beginkw:
+        case Type::elsifkw:
+        case Type::elsekw:
+        case Type::eof:
+            return;
+        default:
+            this->next_token();
+        }
+    }
+}
+
+void Parser::skip_to_subprogram()
 {
-    std::string pos = std::to_string(this->get_token().getPos());
-    std::string row = std::to_string(this->get_token().getRow());
-    std::string value = this->get_token().getValue();
-    std::string type = type_to_str(this->get_token().getType());
-    message += " pos=" + pos + " row=" + row + " type=" + type + " value=" + value;
-    std::cout << message << std::endl;
-    throw std::runtime_error(message);
+    // Ошибка в заголовке подпрограммы: её тело не разобрать, пропускаем до следующей подпрограммы
+    while (!this->token_matches(Type::eof) && !this->is_token_in_firsts(Rule::root_stmt))
+    {
+        this->next_token();
+    }
 }
 
 void Parser::next_token()
@@ -100,18 +173,17 @@ void Parser::next_token()
     else
     {
         // Забираем токен из списка будущих токенов
-        this->token = this->future_tokens[0];
-        this->future_tokens.erase(this->future_tokens.begin());
+        this->token = this->future_tokens.pop();
     }
 }
 
 Token Parser::forward(int k)
 {
-    while (this->future_tokens.size() < k)
+    while (this->future_tokens.size() < static_cast<std::size_t>(k))
     {
-        this->future_tokens.push_back(this->lexer->getToken());
+        this->future_tokens.push(this->lexer->getToken());
     }
-    return this->future_tokens[k - 1];
+    return this->future_tokens.peek(k - 1);
 }
 
 Token Parser::get_token()
@@ -138,12 +210,22 @@ ProgramNode *Parser::program()
         | statements EOF
         | EOF
      */
-    ProgramNode *file = new ProgramNode();
-    if (this->is_token_in_firsts("statements"))
+    ProgramNode *file = this->arena->make<ProgramNode>();
+    while (true)
     {
-        this->statements(file);
+        if (this->is_token_in_firsts(Rule::statements))
+        {
+            this->statements(file);
+        }
+        if (this->token_matches(Type::eof))
+        {
+            break;
+        }
+        this->report("Unexpected token");
+        this->next_token();
+        this->skip_to_subprogram();
     }
-    file->add_child(new Leaf(this->check_get_next(Type::eof)));
+    file->add_child(this->arena->make<Leaf>(this->check_get_next(Type::eof)));
     return file;
 };
 
@@ -154,7 +236,7 @@ void Parser::statements(BlockNode *parent_block)
         | statement statements
         | statement
      */
-    while (this->is_token_in_firsts("statements"))
+    while (this->is_token_in_firsts(Rule::statements))
     {
         this->statement(parent_block);
     }
@@ -167,17 +249,31 @@ void Parser::statement(BlockNode *parent_block)
         | root_stmt
         | nested_stmt
      */
-    if (this->is_token_in_firsts("root_stmt"))
-    {
-        this->root_stmt(parent_block);
-    }
-    else if (this->is_token_in_firsts("nested_stmt"))
+    try
     {
-        this->nested_stmt(parent_block);
+        if (this->is_token_in_firsts(Rule::root_stmt))
+        {
+            try
+            {
+                this->root_stmt(parent_block);
+            }
+            catch (const SyntaxError &)
+            {
+                this->skip_to_subprogram();
+            }
+        }
+        else if (this->is_token_in_firsts(Rule::nested_stmt))
+        {
+            this->nested_stmt(parent_block);
+        }
+        else
+        {
+            this->error("statement");
+        }
     }
-    else
+    catch (const SyntaxError &)
     {
-        this->error("statement");
+        this->synchronize();
     }
 }
 
@@ -188,11 +284,11 @@ void Parser::root_stmt(BlockNode *parent_block)
         | function_declaration SEMICOLON
         | procedure_declaration SEMICOLON
      */
-    if (this->is_token_in_firsts("function_declaration"))
+    if (this->is_token_in_firsts(Rule::function_declaration))
     {
         parent_block->add_child(this->function_declaration());
     }
-    else if (this->is_token_in_firsts("procedure_declaration"))
+    else if (this->is_token_in_firsts(Rule::procedure_declaration))
     {
         parent_block->add_child(this->procedure_declaration());
     }
@@ -211,27 +307,27 @@ FunctionNode *Parser::function_declaration()
         | FUNCTIONKW ID LPR RPR RETURNKW ID IS variable_declarations BEGINKW block ENDKW ID
      */
     this->check_get_next(Type::functionkw);
-    Leaf *id = new Leaf(this->check_get_next(Type::id));
+    Leaf *id = this->arena->make<Leaf>(this->check_get_next(Type::id));
     this->check_get_next(Type::lpr);
     FormalParamsNode *formal_params;
-    if (this->is_token_in_firsts("formal_params"))
+    if (this->is_token_in_firsts(Rule::formal_params))
     {
         formal_params = this->formal_params();
     }
     else
     {
-        formal_params = new FormalParamsNode({}, {});
+        formal_params = this->arena->make<FormalParamsNode>(std::vector<Leaf *>(), std::vector<Leaf *>());
     }
     this->check_get_next(Type::rpr);
     this->check_get_next(Type::returnkw);
-    Leaf *return_type = new Leaf(this->check_get_next(Type::id));
+    Leaf *return_type = this->arena->make<Leaf>(this->check_get_next(Type::id));
     this->check_get_next(Type::is);
     auto declarations = this->variable_declarations();
     this->check_get_next(Type::beginkw);
     BlockNode *body = this->block();
     this->check_get_next(Type::endkw);
     this->check_get_next(Type::id);
-    return new FunctionNode(id, formal_params, return_type, body, declarations);
+    return this->arena->make<FunctionNode>(id, formal_params, return_type, body, declarations);
 };
 
 ProcedureNode *Parser::procedure_declaration()
@@ -242,16 +338,16 @@ ProcedureNode *Parser::procedure_declaration()
         | PROCEDUREKW ID LPR RPR IS variable_declarations BEGINKW block ENDKW ID
      */
     this->check_get_next(Type::procedurekw);
-    Leaf *id = new Leaf(this->check_get_next(Type::id));
+    Leaf *id = this->arena->make<Leaf>(this->check_get_next(Type::id));
     this->check_get_next(Type::lpr);
     FormalParamsNode *formal_params;
-    if (this->is_token_in_firsts("formal_params"))
+    if (this->is_token_in_firsts(Rule::formal_params))
     {
         formal_params = this->formal_params();
     }
     else
     {
-        formal_params = new FormalParamsNode({}, {});
+        formal_params = this->arena->make<FormalParamsNode>(std::vector<Leaf *>(), std::vector<Leaf *>());
     }
     this->check_get_next(Type::rpr);
     this->check_get_next(Type::is);
@@ -260,7 +356,7 @@ ProcedureNode *Parser::procedure_declaration()
     BlockNode *body = this->block();
     this->check_get_next(Type::endkw);
     this->check_get_next(Type::id);
-    return new ProcedureNode(id, formal_params, body, declarations);
+    return this->arena->make<ProcedureNode>(id, formal_params, body, declarations);
 }
 
 FormalParamsNode *Parser::formal_params()
@@ -270,12 +366,12 @@ FormalParamsNode *Parser::formal_params()
         | ID COLON ID SEMICOLON formal_params
         | ID COLON ID
      */
-    FormalParamsNode *params = new FormalParamsNode({}, {});
-    while (this->is_token_in_firsts("formal_params"))
+    FormalParamsNode *params = this->arena->make<FormalParamsNode>(std::vector<Leaf *>(), std::vector<Leaf *>());
+    while (this->is_token_in_firsts(Rule::formal_params))
     {
-        Leaf *name = new Leaf(this->check_get_next(Type::id));
+        Leaf *name = this->arena->make<Leaf>(this->check_get_next(Type::id));
         this->check_get_next(Type::colon);
-        Leaf *type = new Leaf(this->check_get_next(Type::id));
+        Leaf *type = this->arena->make<Leaf>(this->check_get_next(Type::id));
         params->add_param(name, type);
         if (this->get_token().getType() == Type::semicolon)
         {
@@ -292,10 +388,17 @@ BlockNode *Parser::block()
         | nested_stmt block
         | nested_stmt
      */
-    BlockNode *block = new BlockNode();
-    while (this->is_token_in_firsts("block"))
+    BlockNode *block = this->arena->make<BlockNode>();
+    while (this->is_token_in_firsts(Rule::block))
     {
-        this->nested_stmt(block);
+        try
+        {
+            this->nested_stmt(block);
+        }
+        catch (const SyntaxError &)
+        {
+            this->synchronize();
+        }
     }
     return block;
 }
@@ -307,11 +410,11 @@ void Parser::nested_stmt(BlockNode *parent_block)
         | compound_stmt SEMICOLON
         | simple_stmt SEMICOLON
      */
-    if (this->is_token_in_firsts("compound_stmt"))
+    if (this->is_token_in_firsts(Rule::compound_stmt))
     {
         this->compound_stmt(parent_block);
     }
-    else if (this->is_token_in_firsts("simple_stmt"))
+    else if (this->is_token_in_firsts(Rule::simple_stmt))
     {
         this->simple_stmt(parent_block);
     }
@@ -326,15 +429,15 @@ void Parser::compound_stmt(BlockNode *parent_block)
         | for_stmt
         | while_stmt
      */
-    if (this->is_token_in_firsts("if_stmt"))
+    if (this->is_token_in_firsts(Rule::if_stmt))
     {
         parent_block->add_child(this->if_stmt());
     }
-    else if (this->is_token_in_firsts("for_stmt"))
+    else if (this->is_token_in_firsts(Rule::for_stmt))
     {
         parent_block->add_child(this->for_stmt());
     }
-    else if (this->is_token_in_firsts("while_stmt"))
+    else if (this->is_token_in_firsts(Rule::while_stmt))
     {
         parent_block->add_child(this->while_stmt());
     }
@@ -356,12 +459,12 @@ IfNode *Parser::if_stmt()
     ExpressionNode *condition = this->expression();
     this->check_get_next(Type::thenkw);
     BlockNode *body = this->block();
-    IfNode *if_node = new IfNode(condition, body);
-    if (this->is_token_in_firsts("elsif_stmt"))
+    IfNode *if_node = this->arena->make<IfNode>(condition, body);
+    if (this->is_token_in_firsts(Rule::elsif_stmt))
     {
         if_node->next_elif = this->elsif_stmt();
     }
-    else if (this->is_token_in_firsts("else_block"))
+    else if (this->is_token_in_firsts(Rule::else_block))
     {
         if_node->next_else = this->else_block();
     }
@@ -382,12 +485,12 @@ ElifNode *Parser::elsif_stmt()
     ExpressionNode *condition = this->expression();
     this->check_get_next(Type::thenkw);
     BlockNode *body = this->block();
-    ElifNode *elif_node = new ElifNode(condition, body);
-    if (this->is_token_in_firsts("elsif_stmt"))
+    ElifNode *elif_node = this->arena->make<ElifNode>(condition, body);
+    if (this->is_token_in_firsts(Rule::elsif_stmt))
     {
         elif_node->next_elif = this->elsif_stmt();
     }
-    else if (this->is_token_in_firsts("else_block"))
+    else if (this->is_token_in_firsts(Rule::else_block))
     {
         elif_node->next_else = this->else_block();
     }
@@ -402,7 +505,7 @@ ElseNode *Parser::else_block()
      */
     this->check_get_next(Type::elsekw);
     BlockNode *body = this->block();
-    return new ElseNode(body);
+    return this->arena->make<ElseNode>(body);
 };
 
 WhileNode *Parser::while_stmt()
@@ -417,7 +520,7 @@ WhileNode *Parser::while_stmt()
     BlockNode *body = this->block();
     this->check_get_next(Type::endkw);
     this->check_get_next(Type::loopkw);
-    return new WhileNode(condition, body);
+    return this->arena->make<WhileNode>(condition, body);
 };
 
 ForNode *Parser::for_stmt()
@@ -427,13 +530,13 @@ ForNode *Parser::for_stmt()
         | FORKW ID IN (NUMBER | ID) DOUBLEDOT (NUMBER | ID) LOOPKW block ENDKW LOOPKW
      */
     this->check_get_next(Type::forkw);
-    Leaf *iterator = new Leaf(this->check_get_next(Type::id));
+    Leaf *iterator = this->arena->make<Leaf>(this->check_get_next(Type::id));
     this->check_get_next(Type::in);
     Leaf *from;
     Leaf *to;
     if (this->token_matches_any({Type::number, Type::id}))
     {
-        from = new Leaf(this->get_token());
+        from = this->arena->make<Leaf>(this->get_token());
         this->next_token();
     }
     else
@@ -443,7 +546,7 @@ ForNode *Parser::for_stmt()
     this->check_get_next(Type::doubledot);
     if (this->token_matches_any({Type::number, Type::id}))
     {
-        to = new Leaf(this->get_token());
+        to = this->arena->make<Leaf>(this->get_token());
         this->next_token();
     }
     else
@@ -454,7 +557,7 @@ ForNode *Parser::for_stmt()
     BlockNode *body = this->block();
     this->check_get_next(Type::endkw);
     this->check_get_next(Type::loopkw);
-    return new ForNode(iterator, from, to, body);
+    return this->arena->make<ForNode>(iterator, from, to, body);
 };
 
 void Parser::simple_stmt(BlockNode *parent_block)
@@ -465,15 +568,15 @@ void Parser::simple_stmt(BlockNode *parent_block)
         | expression
         | return_stmt
      */
-    if (this->is_token_in_firsts("assignment") && this->forward(1).getType() == Type::assign)
+    if (this->is_token_in_firsts(Rule::assignment) && this->forward(1).getType() == Type::assign)
     {
         parent_block->add_child(this->assignment());
     }
-    else if (this->is_token_in_firsts("expression"))
+    else if (this->is_token_in_firsts(Rule::expression))
     {
         parent_block->add_child(this->expression());
     }
-    else if (this->is_token_in_firsts("return_stmt"))
+    else if (this->is_token_in_firsts(Rule::return_stmt))
     {
         parent_block->add_child(this->return_stmt());
     }
@@ -489,10 +592,10 @@ AssignmentNode *Parser::assignment()
     assignment:
         | ID ASSIGN expression
      */
-    Leaf *left = new Leaf(this->check_get_next(Type::id));
+    Leaf *left = this->arena->make<Leaf>(this->check_get_next(Type::id));
     this->check_get_next(Type::assign);
     ExpressionNode *right = this->expression();
-    return new AssignmentNode(left, right);
+    return this->arena->make<AssignmentNode>(left, right);
 };
 
 ReturnNode *Parser::return_stmt()
@@ -502,7 +605,7 @@ ReturnNode *Parser::return_stmt()
         | RETURNKW expression
      */
     this->check_get_next(Type::returnkw);
-    return new ReturnNode(this->expression());
+    return this->arena->make<ReturnNode>(this->expression());
 };
 
 ExpressionNode *Parser::expression()
@@ -510,201 +613,58 @@ ExpressionNode *Parser::expression()
     /*
     expression:
         | disjunction
-     */
-    return this->disjunction();
-};
-
-ExpressionNode *Parser::disjunction()
-{
-    /*
-    disjunction:
-        | conjunction OR disjunction
-        | conjunction
-     */
-    ExpressionNode *left = this->conjunction();
-    if (token_matches(Type::orop))
-    {
-        Token op = this->check_get_next(Type::orop);
-        ExpressionNode *right = this->conjunction();
-        BinaryNode *op_node = new BinaryNode(left, new Leaf(op), right);
-        while (token_matches(Type::orop))
-        {
-            op = this->check_get_next(Type::orop);
-            right = this->conjunction();
-            op_node = new BinaryNode(op_node, new Leaf(op), right);
-        }
-        return op_node;
-    }
-    else
-    {
-        return left;
-    }
-};
-
-ExpressionNode *Parser::conjunction()
-{
-    /*
-    conjunction:
-        | inversion AND conjunction
-        | inversion
-     */
-    ExpressionNode *left = this->inversion();
-    if (token_matches(Type::andop))
-    {
-        Token op = this->check_get_next(Type::andop);
-        ExpressionNode *right = this->inversion();
-        BinaryNode *op_node = new BinaryNode(left, new Leaf(op), right);
-        while (token_matches(Type::andop))
-        {
-            op = this->check_get_next(Type::andop);
-            right = this->inversion();
-            op_node = new BinaryNode(op_node, new Leaf(op), right);
-        }
-        return op_node;
-    }
-    else
-    {
-        return left;
-    }
-};
 
-ExpressionNode *Parser::inversion()
-{
-    /*
-    inversion:
-        | NOT inversion
-        | comparison
-     */
-    if (this->get_token().getType() == Type::notop)
-    {
-        Token op = this->check_get_next(Type::notop);
-        ExpressionNode *operand = this->inversion();
-        return new UnaryNode(new Leaf(op), operand);
-    }
-    else
-    {
-        return this->comparison();
-    }
+    Уровни disjunction, conjunction, inversion, comparison, sum, term и factor грамматики
+    разбираются методом приоритетов операторов: сила связывания берётся из BINDING_POWER
+    */
+    return this->binary_expression(OR_POWER);
 };
 
-ExpressionNode *Parser::comparison()
+ExpressionNode *Parser::binary_expression(int min_power)
 {
-    /*
-    comparison:
-        | sum GREATER comparison
-        | sum LESS comparison
-        | sum EQUAL comparison
-        | sum NOTEQ comparison
-        | sum GREQUAL comparison
-        | sum LEQUAL comparison
-        | sum
-     */
-    ExpressionNode *left = this->sum();
-    std::vector<Type> ok_ops = {Type::greater, Type::less, Type::equal, Type::noteq, Type::grequal, Type::lequal};
-    if (this->token_matches_any(ok_ops))
+    // Разбирает выражение, в котором операторы связывают не слабее min_power.
+    // Операторы одного уровня левоассоциативны: правый операнд разбирается с силой на единицу больше
+    ExpressionNode *left = this->unary_expression(min_power);
+    int power = BINDING_POWER[static_cast<std::size_t>(this->get_token().getType())];
+    while (power >= min_power)
     {
         Token op = this->get_token();
         this->next_token();
-        ExpressionNode *right = this->sum();
-        BinaryNode *op_node = new BinaryNode(left, new Leaf(op), right);
-        while (this->token_matches_any(ok_ops))
-        {
-            op = this->get_token();
-            this->next_token();
-            right = this->sum();
-            op_node = new BinaryNode(op_node, new Leaf(op), right);
-        }
-        return op_node;
-    }
-    else
-    {
-        return left;
+        ExpressionNode *right = this->binary_expression(power + 1);
+        left = this->arena->make<BinaryNode>(left, this->arena->make<Leaf>(op), right);
+        power = BINDING_POWER[static_cast<std::size_t>(this->get_token().getType())];
     }
+    return left;
 }
 
-ExpressionNode *Parser::sum()
-{
-    /*
-    sum:
-        | term PLUS sum
-        | term MINUS sum
-        | term
-     */
-    ExpressionNode *left = this->term();
-    std::vector<Type> ok_ops = {Type::plus, Type::minus};
-    if (this->token_matches_any(ok_ops))
-    {
-        Token op = this->get_token();
-        this->next_token();
-        ExpressionNode *right = this->term();
-        BinaryNode *op_node = new BinaryNode(left, new Leaf(op), right);
-        while (this->token_matches_any(ok_ops))
-        {
-            op = this->get_token();
-            this->next_token();
-            right = this->term();
-            op_node = new BinaryNode(op_node, new Leaf(op), right);
-        }
-        return op_node;
-    }
-    else
-    {
-        return left;
-    }
-};
-
-ExpressionNode *Parser::term()
-{
-    /*
-    term:
-        | factor STAR term
-        | factor DIV term
-        | factor MOD term
-        | factor
-     */
-    ExpressionNode *left = this->factor();
-    std::vector<Type> ok_ops = {Type::star, Type::div, Type::mod};
-    if (this->token_matches_any(ok_ops))
-    {
-        Token op = this->get_token();
-        this->next_token();
-        ExpressionNode *right = this->factor();
-        BinaryNode *op_node = new BinaryNode(left, new Leaf(op), right);
-        while (this->token_matches_any(ok_ops))
-        {
-            op = this->get_token();
-            this->next_token();
-            right = this->factor();
-            op_node = new BinaryNode(op_node, new Leaf(op), right);
-        }
-        return op_node;
-    }
-    else
-    {
-        return left;
-    }
-};
-
-ExpressionNode *Parser::factor()
+ExpressionNode *Parser::unary_expression(int min_power)
 {
     /*
+    inversion:
+        | NOT inversion
+        | comparison
     factor:
         | PLUS factor
         | MINUS factor
         | primary
      */
-    if (this->token_matches_any({Type::plus, Type::minus}))
+    // NOT допустим только там, где грамматика ждёт inversion, и охватывает сравнение целиком
+    if (this->token_matches(Type::notop) && min_power <= COMPARISON_POWER)
     {
-        Token op = this->get_token();
-        this->next_token();
-        ExpressionNode *operand = this->factor();
-        return new UnaryNode(new Leaf(op), operand);
+        Token op = this->check_get_next(Type::notop);
+        ExpressionNode *operand = this->binary_expression(COMPARISON_POWER);
+        return this->arena->make<UnaryNode>(this->arena->make<Leaf>(op), operand);
     }
-    else
+    // Унарные плюс и минус относятся только к ближайшему множителю
+    if (this->token_matches(Type::plus) || this->token_matches(Type::minus))
     {
-        return this->primary();
+        Token op = this->get_token();
+        this->next_token();
+        ExpressionNode *operand = this->unary_expression(PREFIX_POWER);
+        return this->arena->make<UnaryNode>(this->arena->make<Leaf>(op), operand);
     }
-};
+    return this->primary();
+}
 
 ExpressionNode *Parser::primary()
 {
@@ -721,13 +681,13 @@ ExpressionNode *Parser::primary()
         this->check_get_next(Type::rpr);
         return expr;
     }
-    else if (this->is_token_in_firsts("atom"))
+    else if (this->is_token_in_firsts(Rule::atom))
     {
         Leaf *atom = this->atom();
-        if (this->is_token_in_firsts("func_call"))
+        if (this->is_token_in_firsts(Rule::func_call))
         {
             ActualParamsNode *params = this->func_call();
-            return new CallNode(atom->token, params);
+            return this->arena->make<CallNode>(atom->token, params);
         }
         return atom;
     }
@@ -743,7 +703,7 @@ ActualParamsNode *Parser::func_call()
         | LPR RPR
      */
     this->check_get_next(Type::lpr);
-    if (this->is_token_in_firsts("actual_params"))
+    if (this->is_token_in_firsts(Rule::actual_params))
     {
         ActualParamsNode *params = this->actual_params();
         this->check_get_next(Type::rpr);
@@ -752,7 +712,7 @@ ActualParamsNode *Parser::func_call()
     else
     {
         this->check_get_next(Type::rpr);
-        return new ActualParamsNode({});
+        return this->arena->make<ActualParamsNode>(std::vector<ExpressionNode *>());
     }
 };
 
@@ -766,7 +726,7 @@ Leaf *Parser::atom()
      */
     if (this->token_matches_any({Type::id, Type::string, Type::number}))
     {
-        Leaf *leaf = new Leaf(this->get_token());
+        Leaf *leaf = this->arena->make<Leaf>(this->get_token());
         this->next_token();
         return leaf;
     }
@@ -784,8 +744,8 @@ ActualParamsNode *Parser::actual_params()
         | expression COMMA actual_params
         | expression
      */
-    ActualParamsNode *params = new ActualParamsNode({});
-    while (this->is_token_in_firsts("actual_params"))
+    ActualParamsNode *params = this->arena->make<ActualParamsNode>(std::vector<ExpressionNode *>());
+    while (this->is_token_in_firsts(Rule::actual_params))
     {
         params->add_child(this->expression());
         if (this->get_token().getType() == Type::comma)
@@ -803,10 +763,17 @@ std::vector<VariableDeclarationNode *> Parser::variable_declarations()
         | variable_declaration SEMICOLON
     */
     std::vector<VariableDeclarationNode *> result = {};
-    while (this->is_token_in_firsts("variable_declaration"))
+    while (this->is_token_in_firsts(Rule::variable_declaration))
     {
-        result.push_back(this->variable_declaration());
-        this->check_get_next(Type::semicolon);
+        try
+        {
+            result.push_back(this->variable_declaration());
+            this->check_get_next(Type::semicolon);
+        }
+        catch (const SyntaxError &)
+        {
+            this->synchronize();
+        }
     }
     return result;
 };
@@ -823,7 +790,7 @@ VariableDeclarationNode *Parser::variable_declaration()
     if (this->token_matches(Type::id))
     {
         Token type = this->check_get_next(Type::id);
-        return new VariableDeclarationNode(id, new Leaf(type));
+        return this->arena->make<VariableDeclarationNode>(id, this->arena->make<Leaf>(type));
     }
     else
     {
@@ -831,10 +798,10 @@ VariableDeclarationNode *Parser::variable_declaration()
         this->check_get_next(Type::lpr);
         this->check_get_next(Type::number);
         this->check_get_next(Type::doubledot);
-        int size = std::stoi(this->check_get_next(Type::number).getValue());
+        int size = std::stoi(std::string(this->check_get_next(Type::number).getValue()));
         this->check_get_next(Type::rpr);
         this->check_get_next(Type::ofkw);
         Token type = this->check_get_next(Type::id);
-        return new VariableDeclarationNode(id, new Leaf(type), size);
+        return this->arena->make<VariableDeclarationNode>(id, this->arena->make<Leaf>(type), size);
     }
 }
@@ -0,0 +1,190 @@
+#include <axx/lexer/Scan.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AXX_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AXX_AVX2
+#else
+#define AXX_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace
+{
+    struct Blank
+    {
+        static bool keep(char _c)
+        {
+            return _c == ' ' || _c == '\t' || _c == '\r';
+        }
+#ifdef AXX_SIMD
+        static unsigned int stop(__m128i _v)
+        {
+            __m128i m = _mm_or_si128(_mm_or_si128(
+                _mm_cmpeq_epi8(_v, _mm_set1_epi8(' ')),
+                _mm_cmpeq_epi8(_v, _mm_set1_epi8('\t'))),
+                _mm_cmpeq_epi8(_v, _mm_set1_epi8('\r')));
+            return ~static_cast<unsigned int>(_mm_movemask_epi8(m)) & 0xFFFFu;
+        }
+        AXX_AVX2 static unsigned int stop(__m256i _v)
+        {
+            __m256i m = _mm256_or_si256(_mm256_or_si256(
+                _mm256_cmpeq_epi8(_v, _mm256_set1_epi8(' ')),
+                _mm256_cmpeq_epi8(_v, _mm256_set1_epi8('\t'))),
+                _mm256_cmpeq_epi8(_v, _mm256_set1_epi8('\r')));
+            return ~static_cast<unsigned int>(_mm256_movemask_epi8(m));
+        }
+#endif
+    };
+
+    struct Line
+    {
+        static bool keep(char _c)
+        {
+            return _c != '\n';
+        }
+#ifdef AXX_SIMD
+        static unsigned int stop(__m128i _v)
+        {
+            return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_v, _mm_set1_epi8('\n'))));
+        }
+        AXX_AVX2 static unsigned int stop(__m256i _v)
+        {
+            return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_v, _mm256_set1_epi8('\n'))));
+        }
+#endif
+    };
+
+    // Байты сравниваются как знаковые, поэтому всё, что не ASCII, в диапазоны не попадает.
+    // c | 0x20 переводит заглавные буквы в строчные и не делает буквой ни один другой символ.
+    // Подчёркивание серию прерывает: два подчёркивания подряд в идентификаторе Ada - ошибка,
+    // и каждое из них разбирает автомат лексера
+    struct Alnum
+    {
+        static bool keep(char _c)
+        {
+            const char lower = static_cast<char>(_c | 0x20);
+            return (lower >= 'a' && lower <= 'z') || (_c >= '0' && _c <= '9');
+        }
+#ifdef AXX_SIMD
+        static unsigned int stop(__m128i _v)
+        {
+            __m128i lower = _mm_or_si128(_v, _mm_set1_epi8(0x20));
+            __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), lower));
+            __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(_v, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), _v));
+            return ~static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(alpha, digit))) & 0xFFFFu;
+        }
+        AXX_AVX2 static unsigned int stop(__m256i _v)
+        {
+            __m256i lower = _mm256_or_si256(_v, _mm256_set1_epi8(0x20));
+            __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+            __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(_v, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), _v));
+            return ~static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_or_si256(alpha, digit)));
+        }
+#endif
+    };
+
+    typedef const char* (*kernel_t)(const char*, const char*);
+
+    template <typename Match>
+    const char* run_scalar(const char* _begin, const char* _end)
+    {
+        while (_begin != _end && Match::keep(*_begin))
+            _begin++;
+        return _begin;
+    }
+
+#ifdef AXX_SIMD
+    inline unsigned int first(unsigned int _mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, _mask);
+        return index;
+#else
+        return __builtin_ctz(_mask);
+#endif
+    }
+
+    template <typename Match>
+    const char* run_sse2(const char* _begin, const char* _end)
+    {
+        while (_end - _begin >= 16)
+        {
+            unsigned int stop = Match::stop(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_begin)));
+            if (stop)
+                return _begin + first(stop);
+            _begin += 16;
+        }
+        return run_scalar<Match>(_begin, _end);
+    }
+
+    template <typename Match>
+    AXX_AVX2 const char* run_avx2(const char* _begin, const char* _end)
+    {
+        while (_end - _begin >= 32)
+        {
+            unsigned int stop = Match::stop(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(_begin)));
+            if (stop)
+                return _begin + first(stop);
+            _begin += 32;
+        }
+        return run_sse2<Match>(_begin, _end);
+    }
+
+    bool has_avx2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        // Регистры AVX должны сохраняться системой (OSXSAVE и XCR0)
+        if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+            return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+    struct Kernels
+    {
+        kernel_t blanks;
+        kernel_t newline;
+        kernel_t alnum;
+    };
+
+    Kernels select()
+    {
+#ifdef AXX_SIMD
+        if (has_avx2())
+            return {run_avx2<Blank>, run_avx2<Line>, run_avx2<Alnum>};
+        return {run_sse2<Blank>, run_sse2<Line>, run_sse2<Alnum>};
+#else
+        return {run_scalar<Blank>, run_scalar<Line>, run_scalar<Alnum>};
+#endif
+    }
+
+    const Kernels kernels = select();
+}
+
+const char* skip_blanks(const char* _begin, const char* _end)
+{
+    return kernels.blanks(_begin, _end);
+}
+
+const char* find_newline(const char* _begin, const char* _end)
+{
+    return kernels.newline(_begin, _end);
+}
+
+const char* skip_alnum(const char* _begin, const char* _end)
+{
+    return kernels.alnum(_begin, _end);
+}
@@ -1,12 +1,65 @@
 #include <axx/semantic/SemanticAnalyzer.hpp>
+#include <axx/AST/ASTNode.hpp>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
 
-SemanticAnalyzer::SemanticAnalyzer()
+SemanticAnalyzer::SemanticAnalyzer(Interner& _interner, Diagnostics& _diagnostics, unsigned int _threads) :
+    interner(_interner), diagnostics(_diagnostics), globals(std::make_unique<SemanticGlobals>(_interner)), threads(_threads)
 {
-    visitor = std::make_unique<SemanticVisitor>();
-    visitor->stdinit();
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
 }
 
 void SemanticAnalyzer::check(AST* _tree)
 {
-    _tree->accept(visitor.get());
+    std::vector<BaseASTNode*> units;
+    if (auto program = dynamic_cast<ProgramNode*>(_tree->getRoot()))
+        units = program->children;
+    else
+        units.push_back(_tree->getRoot());
+
+    // Сообщения каждой единицы копятся отдельно и сливаются в порядке текста, а не по времени
+    std::vector<Diagnostics> found(units.size());
+
+    // Фаза 1: сигнатуры в порядке текста, повторное имя - ошибка у второго объявления
+    for (std::size_t i = 0; i < units.size(); i++)
+    {
+        if (auto function = dynamic_cast<FunctionNode*>(units[i]))
+            globals->declare(function->id, function->formal_params,
+                globals->types.named(interner.symbol(function->return_type->token)).first, found[i]);
+        else if (auto procedure = dynamic_cast<ProcedureNode*>(units[i]))
+            globals->declare(procedure->id, procedure->formal_params, TypeTable::VOID, found[i]);
+    }
+
+    // Фаза 2: глобальная таблица только читается, а все идентификаторы дерева уже лежат
+    // в Interner, так что потоки делят лишь TypeTable со своим мьютексом
+    std::atomic<std::size_t> next(0);
+    auto work = [&]() {
+        for (std::size_t i = next++; i < units.size(); i = next++)
+        {
+            SemanticVisitor visitor(*globals, interner, found[i]);
+            units[i]->accept(&visitor);
+        }
+    };
+
+    std::size_t count = threads < units.size() ? threads : units.size();
+    if (count <= 1)
+    {
+        work();
+    }
+    else
+    {
+        std::vector<std::future<void>> workers;
+        for (std::size_t i = 0; i < count; i++)
+            workers.push_back(std::async(std::launch::async, work));
+        for (auto& worker : workers)
+            worker.get();
+    }
+
+    for (auto& unit : found)
+        diagnostics.append(unit);
 }
@@ -0,0 +1,37 @@
+#include <axx/semantic/SemanticGlobals.hpp>
+#include <axx/AST/ASTNode.hpp>
+
+SemanticGlobals::SemanticGlobals(Interner& _interner) : types(_interner), interner(_interner)
+{
+    Symbol tr = {interner.token("true"), TypeTable::BOOL};
+    Symbol fl = {interner.token("false"), TypeTable::BOOL};
+    Symbol wr = {interner.token("Put_Line"), types.named(interner.intern("Put_Line")).first};
+
+    funcs.insert({interner.symbol(wr.token), {TypeTable::VOID, {TypeTable::STRING}}});
+
+    symbols.insert(interner.symbol(tr.token), tr);
+    symbols.insert(interner.symbol(fl.token), fl);
+    symbols.insert(interner.symbol(wr.token), wr);
+}
+
+bool SemanticGlobals::declare(Leaf* _id, FormalParamsNode* _params, type_t _result, Diagnostics& _diagnostics)
+{
+    auto token = _id->token;
+    auto name = interner.symbol(token);
+    // Имя подпрограммы служит и её типом, поэтому не может совпадать с уже известным типом
+    auto symtype = types.named(name);
+    if (symbols.find(name) || !symtype.second)
+    {
+        _diagnostics.error(Problem::AlreadyDefined, token);
+        return false;
+    }
+    symbols.insert(name, {token, symtype.first});
+
+    auto& signature = funcs[name];
+    signature.first = _result;
+    for (auto type : _params->types)
+    {
+        signature.second.push_back(types.named(interner.symbol(type->token)).first);
+    }
+    return true;
+}
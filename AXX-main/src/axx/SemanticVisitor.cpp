@@ -1,8 +1,16 @@
 #include <axx/semantic/SemanticVisitor.hpp>
 #include <axx/AST/ASTNode.hpp>
-#include <stdexcept>
 
-#include <cstdio>
+SemanticVisitor::SemanticVisitor(SemanticGlobals &_globals, Interner &_interner, Diagnostics &_diagnostics) :
+    symtable(&_globals.symbols), types(_globals.types), funcs(_globals.funcs), evaluated_type(TypeTable::VOID),
+    last(Token("", Type::id)), interner(_interner), diagnostics(_diagnostics)
+{
+}
+
+bool SemanticVisitor::compatible(type_t _left, type_t _right)
+{
+    return _left == _right || _left == TypeTable::POISON || _right == TypeTable::POISON;
+}
 
 void SemanticVisitor::visitActualParamsNode(ActualParamsNode *_acceptor) {}
 void SemanticVisitor::visitFormalParamsNode(FormalParamsNode *_acceptor) {}
@@ -12,35 +20,33 @@ void SemanticVisitor::visitLeaf(Leaf *_acceptor)
     auto &token = _acceptor->token;
     if (token.getType() == Type::id)
     {
-        auto symbol = symtable.top()->find(token.getValue());
-        if (symbol == symtable.top()->end())
+        auto symbol = symtable.find(interner.symbol(token));
+        if (!symbol)
         {
-            throw std::runtime_error(
-                "Name " + token.getValue() + " is undefined\n" +
-                "Occured at row: " +
-                std::to_string(token.getRow()) + " position: " + std::to_string(token.getPos()) + "\n");
+            diagnostics.error(Problem::Undefined, token);
+            evaluated_type = TypeTable::POISON;
+            return;
         }
 
-        lastpos = token.getPos();
-        lastrow = token.getRow();
-        evaluated_type = symbol->second.type;
+        last = token;
+        evaluated_type = symbol->type;
     }
     else
     {
         switch (token.getType())
         {
         case Type::string:
-            evaluated_type = set.insert("String").first;
+            evaluated_type = TypeTable::STRING;
             break;
         case Type::number:
             if (token.getValue().find('.') == token.getValue().npos)
-                evaluated_type = set.insert("Integer").first;
+                evaluated_type = TypeTable::INTEGER;
             else
-                evaluated_type = set.insert("Float").first;
+                evaluated_type = TypeTable::FLOAT;
             break;
 
         default:
-            evaluated_type = set.insert("void").first;
+            evaluated_type = TypeTable::VOID;
             break;
         }
     }
@@ -54,75 +60,66 @@ void SemanticVisitor::visitReturnNode(ReturnNode *_acceptor)
 void SemanticVisitor::visitCallNode(CallNode *_acceptor)
 {
     auto token = _acceptor->callable;
-    auto symbol = symtable.top()->find(token.getValue());
-    if (symbol == symtable.top()->end())
+    auto name = interner.symbol(token);
+    auto symbol = symtable.find(name);
+    auto func = funcs.end();
+    if (!symbol)
     {
-        throw std::runtime_error(
-            "Name " + token.getValue() + " is undefined\n" +
-            "Occured at row: " +
-            std::to_string(token.getRow()) + " position: " + std::to_string(token.getPos()) + "\n");
+        diagnostics.error(Problem::Undefined, token);
     }
-    else
+    else if (symbol->type != types.find(name) || (func = funcs.find(name)) == funcs.end())
     {
-        auto symtype = set.find(token.getValue());
-        if (symbol->second.type != symtype)
-        {
-            throw std::runtime_error(
-                "Not a callable at row: " +
-                std::to_string(token.getRow()) +
-                " position: " +
-                std::to_string(token.getPos()) + "\n");
-        }
+        diagnostics.error(Problem::NotCallable, token);
     }
 
-    auto func = funcs.find(token.getValue());
-    if (func->second.second.size() != _acceptor->params->params.size())
+    // Аргументы проверяются и у неизвестной подпрограммы: ошибки в них не зависят от вызова
+    bool counted = func != funcs.end() && func->second.second.size() == _acceptor->params->params.size();
+    if (func != funcs.end() && !counted)
     {
-        throw std::runtime_error(
-            "Parameter quantity mismatch occured at row: " +
-            std::to_string(token.getRow()) + " position: " + std::to_string(token.getPos()) + "\n");
+        diagnostics.error(Problem::ParameterCount, token);
     }
 
-    auto arg_iter = func->second.second.begin();
-
     for (auto &par : _acceptor->params->params)
     {
         par->accept(this);
-        if (evaluated_type != *arg_iter)
+        if (counted && !compatible(evaluated_type, func->second.second.front()))
         {
-            throw std::runtime_error(
-                "Parameter type mismatch occured at row: " +
-                std::to_string(lastrow) + " position: " + std::to_string(lastpos) + "\n");
+            diagnostics.error(Problem::ParameterType, token, last);
         }
     }
-    evaluated_type = func->second.first;
-    lastpos = token.getPos();
-    lastrow = token.getRow();
+    evaluated_type = func != funcs.end() ? func->second.first : TypeTable::POISON;
+    last = token;
 }
 
 void SemanticVisitor::visitAssignmentNode(AssignmentNode *_acceptor)
 {
     auto token = _acceptor->left->token;
-    auto symbol = symtable.top()->find(token.getValue());
-    if (symbol == symtable.top()->end())
+    auto symbol = symtable.find(interner.symbol(token));
+    if (!symbol)
     {
-        throw std::runtime_error(
-            "Name " + token.getValue() + " is undefined\n" +
-            "Occured at row: " +
-            std::to_string(token.getRow()) + " position: " + std::to_string(token.getPos()) + "\n");
+        diagnostics.error(Problem::Undefined, token);
     }
     _acceptor->right->accept(this);
-    if (symbol->second.type == set.find("void"))
+    if (!symbol)
+    {
+        evaluated_type = TypeTable::VOID;
+        return;
+    }
+    if (symbol->parameter)
+    {
+        // Параметры передаются в режиме in, а String - по константной ссылке
+        diagnostics.error(Problem::AssignToParameter, token);
+    }
+    else if (symbol->type == TypeTable::VOID)
     {
-        symbol->second.type = evaluated_type;
+        // Тип выводится по первому присваиванию и забывается при выходе из области, где оно было
+        symtable.modify(interner.symbol(token)).type = evaluated_type;
     }
-    else if (symbol->second.type != evaluated_type)
+    else if (!compatible(symbol->type, evaluated_type))
     {
-        throw std::runtime_error(
-            "Type mismatch occured at row: " +
-            std::to_string(token.getRow()) + " position: " + std::to_string(token.getPos()) + "\n");
+        diagnostics.error(Problem::TypeMismatch, token);
     }
-    evaluated_type = set.find("void");
+    evaluated_type = TypeTable::VOID;
 }
 
 void SemanticVisitor::visitBinaryNode(BinaryNode *_acceptor)
@@ -130,11 +127,14 @@ void SemanticVisitor::visitBinaryNode(BinaryNode *_acceptor)
     _acceptor->left->accept(this);
     type_t a = evaluated_type;
     _acceptor->right->accept(this);
-    if (a != evaluated_type)
+    if (!compatible(a, evaluated_type))
+    {
+        diagnostics.error(Problem::TypeMismatch, last);
+        evaluated_type = TypeTable::POISON;
+    }
+    else if (a == TypeTable::POISON)
     {
-        throw std::runtime_error(
-            "Type mismatch occured at row: " +
-            std::to_string(lastrow) + " position: " + std::to_string(lastpos) + "\n");
+        evaluated_type = TypeTable::POISON;
     }
     switch (_acceptor->op->token.getType())
     {
@@ -142,7 +142,7 @@ void SemanticVisitor::visitBinaryNode(BinaryNode *_acceptor)
     case Type::greater:
     case Type::noteq:
     case Type::equal:
-        evaluated_type = set.insert("Bool").first;
+        evaluated_type = TypeTable::BOOL;
         break;
     }
 }
@@ -170,134 +170,62 @@ void SemanticVisitor::visitProgramNode(ProgramNode *_acceptor)
 
 void SemanticVisitor::visitFunctionNode(FunctionNode *_acceptor)
 {
-    for (auto &i : _acceptor->var_declarations)
-    {
-        i->accept(this);
-    }
-    auto token = _acceptor->id->token;
-    auto symbol = symtable.top()->find(token.getValue());
-    auto symtype = set.insert(token.getValue());
-    if (symbol == symtable.top()->end() && symtype.second)
-    {
-        symtable.top()->insert({token.getValue(), {token, symtype.first}});
-        symtable.push(std::make_unique<localtable_t>(*symtable.top()));
-        auto curr = funcs.insert({token.getValue(), {}}).first;
-        curr->second.first = set.insert(_acceptor->return_type->token.getValue()).first;
-
-        auto n = _acceptor->formal_params->names.begin();
-        auto t = _acceptor->formal_params->types.begin();
-        while (n != _acceptor->formal_params->names.end() && t != _acceptor->formal_params->types.end())
-        {
-            auto token = (*n)->token;
-            auto type = (*t)->token;
-
-            symtype = set.insert(type.getValue());
-            curr->second.second.push_back(symtype.first);
-
-            auto symbol = symtable.top()->find(token.getValue());
-            if (symbol == symtable.top()->end())
-            {
-                symtable.top()->insert({token.getValue(), {token, symtype.first}});
-            }
-            else
-            {
-                throw std::runtime_error(
-                    "Name " + token.getValue() + " is already defined\n" +
-                    "Defined second time at row : " +
-                    std::to_string(token.getRow()) + " position: " + std::to_string(token.getPos()) + "\n");
-            }
-
-            ++n;
-            ++t;
-        }
-
-        _acceptor->body->accept(this);
-        symtable.pop();
-    }
-    else
-    {
-        throw std::runtime_error(
-            "Name " + token.getValue() + " is already defined\n" +
-            "Defined second time at row : " +
-            std::to_string(token.getRow()) + " position: " + std::to_string(token.getPos()) + "\n");
-    }
+    subprogram(_acceptor->formal_params, _acceptor->var_declarations, _acceptor->body);
 }
 
 void SemanticVisitor::visitProcedureNode(ProcedureNode *_acceptor)
 {
-    for (auto &i : _acceptor->var_declarations)
+    subprogram(_acceptor->formal_params, _acceptor->var_declarations, _acceptor->body);
+}
+
+// Сама подпрограмма уже объявлена в SemanticGlobals::declare, здесь проверяются её
+// переменные, параметры и тело
+void SemanticVisitor::subprogram(FormalParamsNode *_params, std::vector<VariableDeclarationNode *>& _declarations, BlockNode *_body)
+{
+    symtable.enter();
+    for (auto &i : _declarations)
     {
         i->accept(this);
     }
-    auto token = _acceptor->id->token;
-    auto symbol = symtable.top()->find(token.getValue());
-    auto symtype = set.insert(token.getValue());
-    if (symbol == symtable.top()->end() && symtype.second)
-    {
-        symtable.top()->insert({token.getValue(), {token, symtype.first}});
-        symtable.push(std::make_unique<localtable_t>(*symtable.top()));
-        auto curr = funcs.insert({token.getValue(), {}}).first;
-        curr->second.first = set.insert("void").first;
-
-        auto n = _acceptor->formal_params->names.begin();
-        auto t = _acceptor->formal_params->types.begin();
-        while (n != _acceptor->formal_params->names.end() && t != _acceptor->formal_params->types.end())
-        {
-            auto token = (*n)->token;
-            auto type = (*t)->token;
 
-            symtype = set.insert(type.getValue());
-            curr->second.second.push_back(symtype.first);
+    auto n = _params->names.begin();
+    auto t = _params->types.begin();
+    while (n != _params->names.end() && t != _params->types.end())
+    {
+        auto token = (*n)->token;
+        auto type = (*t)->token;
 
-            auto symbol = symtable.top()->find(token.getValue());
-            if (symbol == symtable.top()->end())
-            {
-                symtable.top()->insert({token.getValue(), {token, symtype.first}});
-            }
-            else
-            {
-                throw std::runtime_error(
-                    "Name " + token.getValue() + " is already defined\n" +
-                    "Defined second time at row : " +
-                    std::to_string(token.getRow()) + " position: " + std::to_string(token.getPos()) + "\n");
-            }
-
-            ++n;
-            ++t;
+        if (!symtable.insert(interner.symbol(token), {token, types.named(interner.symbol(type)).first, true}))
+        {
+            diagnostics.error(Problem::AlreadyDefined, token);
         }
 
-        _acceptor->body->accept(this);
-        symtable.pop();
-    }
-    else
-    {
-        throw std::runtime_error(
-            "Name " + token.getValue() + " is already defined\n" +
-            "Defined second time at row : " +
-            std::to_string(token.getRow()) + " position: " + std::to_string(token.getPos()) + "\n");
+        ++n;
+        ++t;
     }
+
+    _body->accept(this);
+    symtable.leave();
 }
 
 void SemanticVisitor::visitElseNode(ElseNode *_acceptor)
 {
-    symtable.push(std::make_unique<localtable_t>(*symtable.top()));
+    symtable.enter();
     _acceptor->body->accept(this);
-    symtable.pop();
+    symtable.leave();
 }
 
 void SemanticVisitor::visitElifNode(ElifNode *_acceptor)
 {
     _acceptor->condition->accept(this);
-    if (evaluated_type != set.find("Bool"))
+    if (!compatible(evaluated_type, TypeTable::BOOL))
     {
-        throw std::runtime_error(
-            "Condition type is not Bool.\nOccured at row: " +
-            std::to_string(lastrow) + " position: " + std::to_string(lastpos) + "\n");
+        diagnostics.error(Problem::ConditionNotBool, last);
     }
 
-    symtable.push(std::make_unique<localtable_t>(*symtable.top()));
+    symtable.enter();
     _acceptor->body->accept(this);
-    symtable.pop();
+    symtable.leave();
 
     if (_acceptor->next_elif)
     {
@@ -312,16 +240,14 @@ void SemanticVisitor::visitElifNode(ElifNode *_acceptor)
 void SemanticVisitor::visitIfNode(IfNode *_acceptor)
 {
     _acceptor->condition->accept(this);
-    if (evaluated_type != set.find("Bool"))
+    if (!compatible(evaluated_type, TypeTable::BOOL))
     {
-        throw std::runtime_error(
-            "Condition type is not Bool.\nOccured at row: " +
-            std::to_string(lastrow) + " position: " + std::to_string(lastpos) + "\n");
+        diagnostics.error(Problem::ConditionNotBool, last);
     }
 
-    symtable.push(std::make_unique<localtable_t>(*symtable.top()));
+    symtable.enter();
     _acceptor->body->accept(this);
-    symtable.pop();
+    symtable.leave();
 
     if (_acceptor->next_elif)
     {
@@ -337,16 +263,14 @@ void SemanticVisitor::visitWhileNode(WhileNode *_acceptor)
 {
     _acceptor->condition->accept(this);
 
-    if (evaluated_type != set.find("Bool"))
+    if (!compatible(evaluated_type, TypeTable::BOOL))
     {
-        throw std::runtime_error(
-            "Condition type is not Bool.\nOccured at row: " +
-            std::to_string(lastrow) + " position: " + std::to_string(lastpos) + "\n");
+        diagnostics.error(Problem::ConditionNotBool, last);
     }
 
-    symtable.push(std::make_unique<localtable_t>(*symtable.top()));
+    symtable.enter();
     _acceptor->body->accept(this);
-    symtable.pop();
+    symtable.leave();
 }
 
 void SemanticVisitor::visitForNode(ForNode *_acceptor)
@@ -362,17 +286,15 @@ void SemanticVisitor::visitForNode(ForNode *_acceptor)
     _acceptor->to->accept(this);
     c = evaluated_type;
 
-    if (!(a == b && b == c))
+    if (!(compatible(a, b) && compatible(b, c)))
     {
-        throw std::runtime_error(
-            "Type mismatch occured at row: " +
-            std::to_string(iter.getRow()) + " position: " + std::to_string(iter.getPos()) + "\n");
+        diagnostics.error(Problem::TypeMismatch, iter);
     }
 
-    symtable.push(std::make_unique<localtable_t>(*symtable.top()));
-    symtable.top()->insert({iter.getValue(), {iter, a}});
+    symtable.enter();
+    symtable.insert(interner.symbol(iter), {iter, a});
     _acceptor->body->accept(this);
-    symtable.pop();
+    symtable.leave();
 }
 
 void SemanticVisitor::visitVarDeclNode(VariableDeclarationNode *_acceptor)
@@ -384,57 +306,35 @@ void SemanticVisitor::visitVarDeclNode(VariableDeclarationNode *_acceptor)
         if (_acceptor->type)
         {
             auto &type = _acceptor->type->token;
-            symtype = set.insert(type.getValue()).first;
+            symtype = types.named(interner.symbol(type)).first;
         }
         else
         {
-            symtype = set.insert("void").first;
+            symtype = TypeTable::VOID;
         }
-        auto symbol = symtable.top()->find(token.getValue());
-        if (symbol == symtable.top()->end())
+        auto symbol = symtable.find(interner.symbol(token));
+        if (!symbol)
         {
-            symtable.top()->insert({token.getValue(), {token, symtype}});
+            symtable.insert(interner.symbol(token), {token, symtype});
         }
         else
         {
-            throw std::runtime_error(
-                "Name " + token.getValue() + " is already defined\n" +
-                "Defined second time at row : " +
-                std::to_string(token.getRow()) + " position: " + std::to_string(token.getPos()) + "\n");
+            diagnostics.error(Problem::AlreadyDefined, token);
         }
     }
     else
     {
         auto &token = _acceptor->var_name;
         auto &type = _acceptor->type->token;
-        std::string typestr = type.getValue() + "[" + std::to_string(_acceptor->size) + "]";
-        auto symbol = symtable.top()->find(token.getValue());
-        auto symtype = set.insert(typestr);
-        if (symbol == symtable.top()->end())
+        auto symbol = symtable.find(interner.symbol(token));
+        auto symtype = types.array(types.named(interner.symbol(type)).first, static_cast<std::uint32_t>(_acceptor->size));
+        if (!symbol)
         {
-            symtable.top()->insert({token.getValue(), {token, symtype.first}});
+            symtable.insert(interner.symbol(token), {token, symtype});
         }
         else
         {
-            throw std::runtime_error(
-                "Name " + token.getValue() + " is already defined\n" +
-                "Defined second time at row : " +
-                std::to_string(token.getRow()) + " position: " + std::to_string(token.getPos()) + "\n");
+            diagnostics.error(Problem::AlreadyDefined, token);
         }
     }
 }
-
-void SemanticVisitor::stdinit()
-{
-    symtable.push(std::make_unique<localtable_t>());
-
-    Symbol tr = {{"true", Type::id}, set.insert("Bool").first};
-    Symbol fl = {{"false", Type::id}, set.insert("Bool").first};
-    Symbol wr = {{"Put_Line", Type::id}, set.insert("Put_Line").first};
-
-    funcs.insert({"Put_Line", {set.insert("void").first, {set.insert("String").first}}});
-
-    symtable.top()->insert({tr.token.getValue(), tr});
-    symtable.top()->insert({fl.token.getValue(), fl});
-    symtable.top()->insert({wr.token.getValue(), wr});
-}
@@ -0,0 +1,134 @@
+#include <axx/token/SourceFile.hpp>
+#include <axx/token/TextStorage.hpp>
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+SourceFile::SourceFile(const std::string& _path) : data(nullptr), size(0), id(0), file(INVALID_HANDLE_VALUE), mapping(nullptr)
+{
+    file = CreateFileA(_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Cannot open " + _path);
+
+    LARGE_INTEGER filesize;
+    if (!GetFileSizeEx(file, &filesize))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Cannot get size of " + _path);
+    }
+    if (static_cast<std::uint64_t>(filesize.QuadPart) > UINT32_MAX)
+    {
+        CloseHandle(file);
+        throw std::runtime_error(_path + " is larger than 4 GiB");
+    }
+    size = static_cast<std::size_t>(filesize.QuadPart);
+    // Пустой файл отобразить нельзя, он просто не содержит данных
+    if (size == 0)
+    {
+        lines.reset(new LineIndex(nullptr, 0));
+        return;
+    }
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping)
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Cannot map " + _path);
+    }
+    id = TextStorage::attach(data);
+    lines.reset(new LineIndex(data, size));
+}
+
+SourceFile::~SourceFile()
+{
+    if (id)
+        TextStorage::detach(id);
+    if (data)
+        UnmapViewOfFile(data);
+    if (mapping)
+        CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE)
+        CloseHandle(file);
+}
+
+#else
+
+SourceFile::SourceFile(const std::string& _path) : data(nullptr), size(0), id(0)
+{
+    int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open " + _path);
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Cannot get size of " + _path);
+    }
+    if (static_cast<std::uint64_t>(info.st_size) > UINT32_MAX)
+    {
+        ::close(fd);
+        throw std::runtime_error(_path + " is larger than 4 GiB");
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    // Пустой файл отобразить нельзя, он просто не содержит данных
+    if (size != 0)
+    {
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + _path);
+        }
+        madvise(addr, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(addr);
+        id = TextStorage::attach(data);
+    }
+    // Отображение остаётся действительным и после закрытия дескриптора
+    ::close(fd);
+    lines.reset(new LineIndex(data, size));
+}
+
+SourceFile::~SourceFile()
+{
+    if (id)
+        TextStorage::detach(id);
+    if (data)
+        munmap(const_cast<char*>(data), size);
+}
+
+#endif
+
+const char* SourceFile::getData() const
+{
+    return data;
+}
+
+std::size_t SourceFile::getSize() const
+{
+    return size;
+}
+
+std::uint16_t SourceFile::getId() const
+{
+    return id;
+}
+
+const LineIndex& SourceFile::getLines() const
+{
+    return *lines;
+}
@@ -1,3 +1,3 @@
 #include <axx/semantic/Symbol.hpp>
 
-Symbol::Symbol(Token _token, std::set<std::string>::const_iterator _type) : token(_token), type(_type) {}
+Symbol::Symbol(Token _token, type_t _type, bool _parameter) : token(_token), type(_type), parameter(_parameter) {}
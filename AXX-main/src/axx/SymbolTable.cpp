@@ -0,0 +1,84 @@
+#include <axx/semantic/SymbolTable.hpp>
+#include <stdexcept>
+
+SymbolTable::SymbolTable(const SymbolTable* _parent) : parent(_parent) {}
+
+void SymbolTable::remember(symbol_t _name, std::optional<Binding> _previous)
+{
+    // В глобальной области отменять нечего
+    if (!scopes.empty())
+    {
+        journal.emplace_back(_name, std::move(_previous));
+    }
+}
+
+void SymbolTable::enter()
+{
+    scopes.push_back(journal.size());
+}
+
+void SymbolTable::leave()
+{
+    std::size_t mark = scopes.back();
+    scopes.pop_back();
+    while (journal.size() > mark)
+    {
+        auto& entry = journal.back();
+        if (entry.second)
+        {
+            bindings.insert_or_assign(entry.first, *entry.second);
+        }
+        else
+        {
+            bindings.erase(entry.first);
+        }
+        journal.pop_back();
+    }
+}
+
+const Symbol* SymbolTable::find(symbol_t _name) const
+{
+    auto binding = bindings.find(_name);
+    if (binding != bindings.end())
+    {
+        return &binding->second.symbol;
+    }
+    return parent ? parent->find(_name) : nullptr;
+}
+
+bool SymbolTable::insert(symbol_t _name, const Symbol& _symbol)
+{
+    if (parent && parent->find(_name))
+    {
+        return false;
+    }
+    auto result = bindings.insert({_name, {_symbol, scopes.size()}});
+    if (result.second)
+    {
+        remember(_name, std::nullopt);
+    }
+    return result.second;
+}
+
+Symbol& SymbolTable::modify(symbol_t _name)
+{
+    auto binding = bindings.find(_name);
+    if (binding == bindings.end())
+    {
+        // Символ родительской таблицы копируется в текущую область
+        const Symbol* inherited = parent ? parent->find(_name) : nullptr;
+        if (!inherited)
+        {
+            throw std::logic_error("Modifying an undeclared symbol");
+        }
+        binding = bindings.insert({_name, {*inherited, scopes.size()}}).first;
+        remember(_name, std::nullopt);
+    }
+    // Запись внешней области сохраняется в журнал и переходит к текущей
+    if (binding->second.depth != scopes.size())
+    {
+        remember(_name, binding->second);
+        binding->second.depth = scopes.size();
+    }
+    return binding->second.symbol;
+}
@@ -0,0 +1,427 @@
+#include <axx/lexer/TableLexer.hpp>
+#include <axx/lexer/Keywords.hpp>
+#include <axx/lexer/Scan.hpp>
+#include <array>
+#include <iostream>
+
+namespace
+{
+    // Состояния автомата, по одному на класс из LexerStates.hpp.
+    // Флаги hasUnderscore (Id) и created (SecondNumPart) вынесены в отдельные состояния
+    namespace state
+    {
+        enum : std::uint8_t
+        {
+            start,
+            skip,
+            id,
+            id_underscore,
+            first_num,
+            second_num_dot,
+            second_num,
+            string,
+            character,
+            colon,
+            semicolon,
+            vertical,
+            dot,
+            plus,
+            minus,
+            star,
+            div,
+            ampersand,
+            greater,
+            less,
+            equal,
+            lpr,
+            rpr,
+            comment,
+            comma,
+            count
+        };
+    }
+
+    // Классы символов: каждый символ из таблицы переходов Lexer получает свой класс
+    namespace cls
+    {
+        enum : std::uint8_t
+        {
+            other,
+            alpha,
+            digit,
+            nul,
+            newline,
+            ampersand,
+            plus,
+            minus,
+            star,
+            div,
+            vertical,
+            less,
+            greater,
+            equal,
+            dot,
+            comma,
+            lpr,
+            rpr,
+            colon,
+            semicolon,
+            quote,
+            apostrophe,
+            underscore,
+            count
+        };
+    }
+
+    // Действия перехода, выполняются в порядке объявления
+    enum Action : std::uint16_t
+    {
+        Keep = 1 << 0,      // символ дописывается в лексему до её выдачи
+        Emit = 1 << 1,      // выдать токен type с местом начала состояния
+        EmitAtPos = 1 << 2, // выдать токен type с местом текущего символа
+        EmitDot = 1 << 3,   // выдать точку с местом текущего символа
+        Eof = 1 << 4,       // выдать конец файла
+        PushDot = 1 << 5,   // дописать '.' в лексему
+        Push = 1 << 6,      // дописать символ в лексему
+        Enter = 1 << 7,     // запомнить место начала нового состояния
+    };
+
+    struct Transition
+    {
+        std::uint8_t next = state::start;
+        std::uint16_t actions = 0;
+        Type type = Type::eof;
+    };
+
+    typedef std::array<std::array<Transition, cls::count>, state::count> table_t;
+
+    constexpr std::array<std::uint8_t, 256> make_classes()
+    {
+        std::array<std::uint8_t, 256> classes = {};
+        for (int c = 'a'; c <= 'z'; c++)
+            classes[c] = cls::alpha;
+        for (int c = 'A'; c <= 'Z'; c++)
+            classes[c] = cls::alpha;
+        for (int c = '0'; c <= '9'; c++)
+            classes[c] = cls::digit;
+        classes['\0'] = cls::nul;
+        classes['\n'] = cls::newline;
+        classes['&'] = cls::ampersand;
+        classes['+'] = cls::plus;
+        classes['-'] = cls::minus;
+        classes['*'] = cls::star;
+        classes['/'] = cls::div;
+        classes['|'] = cls::vertical;
+        classes['<'] = cls::less;
+        classes['>'] = cls::greater;
+        classes['='] = cls::equal;
+        classes['.'] = cls::dot;
+        classes[','] = cls::comma;
+        classes['('] = cls::lpr;
+        classes[')'] = cls::rpr;
+        classes[':'] = cls::colon;
+        classes[';'] = cls::semicolon;
+        classes['"'] = cls::quote;
+        classes['\''] = cls::apostrophe;
+        classes['_'] = cls::underscore;
+        return classes;
+    }
+
+    constexpr Transition go(std::uint8_t next, std::uint16_t actions, Type type = Type::eof)
+    {
+        Transition t;
+        t.next = next;
+        t.actions = actions;
+        t.type = type;
+        return t;
+    }
+
+    // Аналог tablestate из LexerStates.cpp: переход по символу-разделителю
+    constexpr void tablestate(table_t &table, std::uint8_t from, std::uint16_t actions, Type type = Type::eof)
+    {
+        auto &row = table[from];
+        for (auto &t : row)
+            t = go(state::skip, actions | Enter, type);
+        row[cls::ampersand] = go(state::ampersand, actions | Enter, type);
+        row[cls::plus] = go(state::plus, actions | Enter, type);
+        row[cls::minus] = go(state::minus, actions | Enter, type);
+        row[cls::star] = go(state::star, actions | Enter, type);
+        row[cls::div] = go(state::div, actions | Enter, type);
+        row[cls::vertical] = go(state::vertical, actions | Enter, type);
+        row[cls::less] = go(state::less, actions | Enter, type);
+        row[cls::greater] = go(state::greater, actions | Enter, type);
+        row[cls::equal] = go(state::equal, actions | Enter, type);
+        row[cls::dot] = go(state::dot, actions | Enter, type);
+        row[cls::comma] = go(state::comma, actions | Enter, type);
+        row[cls::lpr] = go(state::lpr, actions | Enter, type);
+        row[cls::rpr] = go(state::rpr, actions | Enter, type);
+        row[cls::colon] = go(state::colon, actions | Enter, type);
+        row[cls::semicolon] = go(state::semicolon, actions | Enter, type);
+        row[cls::quote] = go(state::string, actions | Enter, type);
+        row[cls::apostrophe] = go(state::character, actions | Enter, type);
+        // Конец буфера: состояние не меняется
+        row[cls::nul] = go(from, actions | Eof, type);
+    }
+
+    // Начало новой лексемы: идентификатор, число или tablestate
+    constexpr void dispatch(table_t &table, std::uint8_t from, std::uint16_t actions, Type type = Type::eof)
+    {
+        tablestate(table, from, actions, type);
+        table[from][cls::alpha] = go(state::id, actions | Push | Enter, type);
+        table[from][cls::digit] = go(state::first_num, actions | Push | Enter, type);
+    }
+
+    // Состояние, которое выдаёт свой токен на следующем символе
+    constexpr void single(table_t &table, std::uint8_t from, Type type)
+    {
+        dispatch(table, from, Emit, type);
+    }
+
+    constexpr void pair(table_t &table, std::uint8_t from, std::uint8_t second, Type type)
+    {
+        table[from][second] = go(state::skip, Emit | Enter, type);
+    }
+
+    constexpr table_t make_table()
+    {
+        table_t table = {};
+
+        dispatch(table, state::start, 0);
+        table[state::start][cls::newline] = go(state::start, 0);
+
+        dispatch(table, state::skip, 0);
+
+        for (std::uint8_t from : {state::id, state::id_underscore})
+        {
+            single(table, from, Type::id);
+            table[from][cls::alpha] = go(state::id, Push);
+            table[from][cls::digit] = go(state::id, Push);
+            table[from][cls::underscore] = go(state::id_underscore, Push);
+        }
+        table[state::id_underscore][cls::underscore] = go(state::id_underscore, EmitAtPos, Type::unexpected);
+
+        single(table, state::first_num, Type::number);
+        table[state::first_num][cls::digit] = go(state::first_num, Push);
+        table[state::first_num][cls::dot] = go(state::second_num_dot, 0);
+
+        tablestate(table, state::second_num_dot, Emit | EmitDot, Type::number);
+        table[state::second_num_dot][cls::digit] = go(state::second_num, PushDot | Push);
+        tablestate(table, state::second_num, Emit | EmitDot, Type::number);
+        table[state::second_num][cls::digit] = go(state::second_num, Push);
+
+        for (auto &t : table[state::string])
+            t = go(state::string, Push);
+        table[state::string][cls::quote] = go(state::skip, Emit | Enter, Type::string);
+
+        for (auto &t : table[state::character])
+            t = go(state::character, Keep | Push);
+        table[state::character][cls::apostrophe] = go(state::skip, Keep | Emit | Enter, Type::character);
+
+        for (auto &t : table[state::comment])
+            t = go(state::comment, 0);
+        table[state::comment][cls::newline] = go(state::skip, Enter);
+
+        single(table, state::colon, Type::colon);
+        pair(table, state::colon, cls::equal, Type::assign);
+        single(table, state::semicolon, Type::semicolon);
+        single(table, state::vertical, Type::vertical);
+        single(table, state::ampersand, Type::ampersand);
+        single(table, state::plus, Type::plus);
+        single(table, state::lpr, Type::lpr);
+        single(table, state::rpr, Type::rpr);
+        single(table, state::comma, Type::comma);
+        single(table, state::dot, Type::dot);
+        pair(table, state::dot, cls::dot, Type::doubledot);
+        single(table, state::minus, Type::minus);
+        table[state::minus][cls::minus] = go(state::comment, Enter);
+        single(table, state::star, Type::star);
+        pair(table, state::star, cls::star, Type::power);
+        single(table, state::div, Type::div);
+        pair(table, state::div, cls::equal, Type::noteq);
+        single(table, state::greater, Type::greater);
+        pair(table, state::greater, cls::equal, Type::grequal);
+        pair(table, state::greater, cls::greater, Type::rlabbr);
+        single(table, state::less, Type::less);
+        pair(table, state::less, cls::equal, Type::lequal);
+        pair(table, state::less, cls::less, Type::llabbr);
+        pair(table, state::less, cls::greater, Type::box);
+        single(table, state::equal, Type::equal);
+        pair(table, state::equal, cls::greater, Type::arrow);
+
+        return table;
+    }
+
+    constexpr std::array<std::uint8_t, 256> classes = make_classes();
+    constexpr table_t table = make_table();
+}
+
+TableLexer::TableLexer(Interner &_interner) : interner(_interner) {}
+
+void TableLexer::open(std::istream &_stream)
+{
+    filedata.reset(new FileData());
+    input.open(_stream);
+    filedata->input = &input;
+    filedata->lines = input.getLines();
+    current = state::start;
+    initpos = filedata->offset(input.iter);
+}
+
+void TableLexer::open(const std::string &_path)
+{
+    auto source = std::make_shared<const SourceFile>(_path);
+    std::size_t size = source->getSize();
+    open(std::move(source), 0, size);
+}
+
+void TableLexer::open(std::shared_ptr<const SourceFile> _source, std::size_t _begin, std::size_t _end)
+{
+    filedata.reset(new FileData());
+    filedata->source = _source->getData();
+    filedata->sourceSize = _source->getSize();
+    filedata->sourceId = _source->getId();
+    filedata->lines = _source->getLines().getId();
+    input.open(std::move(_source), _begin, _end);
+    filedata->input = &input;
+    // Перевод строки в начале участка из skip, как и в середине файла, запоминает своё место,
+    // а из start он пропускается
+    current = _begin == 0 ? state::start : state::skip;
+    initpos = filedata->offset(input.iter);
+}
+
+std::shared_ptr<const SourceFile> TableLexer::getSource() const
+{
+    return input.getSource();
+}
+
+void TableLexer::setState(LexerStateInterface *_state)
+{
+    // Объекты состояний табличному лексеру не нужны
+    delete _state;
+}
+
+inline void TableLexer::step(char _c)
+{
+    const Transition &t = table[current][classes[static_cast<unsigned char>(_c)]];
+    const std::uint16_t actions = t.actions;
+
+    if (actions & Keep)
+        filedata->push(_c);
+    if (actions & Emit)
+        filedata->put(t.type, initpos);
+    if (actions & EmitAtPos)
+        filedata->put(t.type, filedata->offset(filedata->cursor));
+    if (actions & EmitDot)
+        filedata->put(Type::dot, filedata->offset(filedata->cursor));
+    if (actions & Eof)
+        filedata->put(Type::eof, initpos);
+    if (actions & PushDot)
+        filedata->push('.');
+    if (actions & Push)
+        filedata->push(_c);
+    if (actions & Enter)
+        initpos = filedata->offset(filedata->cursor);
+    current = t.next;
+}
+
+// Серии, на которых автомат остаётся в skip, comment или id, проходятся блоками вместо step
+inline void TableLexer::fastforward()
+{
+    const char* from = input.iter;
+    switch (current)
+    {
+    case state::skip:
+        input.iter = skip_blanks(from, input.end);
+        if (input.iter != from)
+        {
+            initpos = filedata->offset(input.iter - 1);
+        }
+        break;
+    case state::comment:
+        input.iter = find_newline(from, input.end);
+        break;
+    case state::id:
+        input.iter = skip_alnum(from, input.end);
+        if (input.iter != from)
+        {
+            filedata->push(from, input.iter - from);
+        }
+        break;
+    }
+}
+
+void TableLexer::scan()
+{
+    while (filedata->queue.empty() && input.iter != input.end)
+    {
+        fastforward();
+        if (input.iter == input.end)
+            break;
+        filedata->cursor = input.iter;
+        step(*input.iter++);
+    }
+}
+
+void TableLexer::finish()
+{
+    // Файл закончился посреди лексемы: передаём автомату завершающий '\0', как при чтении потока
+    filedata->cursor = input.end;
+    step('\0');
+    if (filedata->queue.empty())
+    {
+        filedata->discard();
+        filedata->put(Type::eof, filedata->offset(input.end));
+    }
+}
+
+Token TableLexer::next()
+{
+    scan();
+    // Порция потока кончилась раньше лексемы: дочитываем поток, а в конце текста завершаем лексему
+    while (filedata->queue.empty() && input.refill())
+    {
+        scan();
+    }
+    if (filedata->queue.empty())
+    {
+        finish();
+    }
+    return filedata->get();
+}
+
+Token TableLexer::read()
+{
+    Token tok = next();
+
+    if (tok.getType() == Type::id)
+    {
+        tok.setType(recognize_keyword(tok.getValue()));
+    }
+    return tok;
+}
+
+Token TableLexer::getToken()
+{
+    Token tok = read();
+    if (tok.getType() == Type::id)
+    {
+        interner.attach(tok);
+    }
+    return tok;
+}
+
+void TableLexer::tokenize(std::vector<Token> &_tokens)
+{
+    do
+    {
+        _tokens.push_back(read());
+    } while (_tokens.back().getType() != Type::eof);
+}
+
+void TableLexer::print_all_tokens() {
+    Token token("", Type::id);
+    while ((token = this->getToken()).getType() != Type::eof) {
+        std::cout << type_to_str(token.getType()) << " " << token.getValue() << "\n";
+    }
+    std::cout << type_to_str(token.getType()) << " " << token.getValue() << "\n";
+}
@@ -0,0 +1,141 @@
+#include <axx/token/TextStorage.hpp>
+#include <axx/token/Interner.hpp>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#define SOURCECOUNT 65536
+#define BLOCKSIZE 65536
+
+namespace
+{
+    std::atomic<const char*> bases[SOURCECOUNT];
+    std::atomic<const Interner*> symbols[SOURCECOUNT];
+    std::atomic<std::uint16_t> generations[SOURCECOUNT];
+    std::mutex mutex;
+    std::vector<std::uint16_t> freeIds;
+    std::uint32_t nextId = 1;
+
+    /// @brief Блоки для текста, которого нет в исходных файлах. Блоками владеет сеанс - таблица
+    /// идентификаторов Interner; с ней они освобождаются, а их номера возвращаются в freeIds
+    struct Session
+    {
+        std::uint16_t area = 0; // Номер таблицы Interner, 0 - текст вне сеансов
+        std::vector<std::unique_ptr<char[]>> blocks;
+        std::vector<std::uint16_t> ids;
+        std::size_t used = BLOCKSIZE;
+        std::size_t size = BLOCKSIZE;
+    };
+
+    // Живые сеансы в порядке создания. Текст без владельца достаётся последнему из них,
+    // а если сеансов нет - хранится до конца программы
+    std::vector<std::unique_ptr<Session>> sessions;
+    Session unowned;
+
+    std::uint16_t allocateId(const char* _base, const Interner* _symbols = nullptr)
+    {
+        std::uint16_t id;
+        if (!freeIds.empty())
+        {
+            id = freeIds.back();
+            freeIds.pop_back();
+        }
+        else if (nextId < SOURCECOUNT)
+        {
+            id = static_cast<std::uint16_t>(nextId++);
+        }
+        else
+        {
+            throw std::runtime_error("Too many source texts");
+        }
+        bases[id].store(_base, std::memory_order_release);
+        symbols[id].store(_symbols, std::memory_order_release);
+        return id;
+    }
+}
+
+std::uint16_t TextStorage::attach(const char* _base)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return allocateId(_base);
+}
+
+std::uint16_t TextStorage::attach(const Interner* _symbols)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::uint16_t id = allocateId(nullptr, _symbols);
+    sessions.emplace_back(new Session());
+    sessions.back()->area = id;
+    return id;
+}
+
+void TextStorage::detach(std::uint16_t _source)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    bases[_source].store(nullptr, std::memory_order_release);
+    symbols[_source].store(nullptr, std::memory_order_release);
+    generations[_source].fetch_add(1, std::memory_order_release);
+    freeIds.push_back(_source);
+
+    // Вместе с таблицей идентификаторов уходят блоки её сеанса
+    for (auto session = sessions.begin(); session != sessions.end(); ++session)
+    {
+        if ((*session)->area != _source)
+            continue;
+        for (std::uint16_t id : (*session)->ids)
+        {
+            bases[id].store(nullptr, std::memory_order_release);
+            generations[id].fetch_add(1, std::memory_order_release);
+            freeIds.push_back(id);
+        }
+        sessions.erase(session);
+        break;
+    }
+}
+
+void TextStorage::store(std::string_view _text, std::uint16_t& _source, std::uint32_t& _offset, std::uint16_t _owner)
+{
+    if (_text.empty())
+    {
+        _source = 0;
+        _offset = 0;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Session* session = sessions.empty() ? &unowned : sessions.back().get();
+    for (auto& s : sessions)
+    {
+        if (s->area == _owner)
+            session = s.get();
+    }
+    if (session->size - session->used < _text.size())
+    {
+        session->size = _text.size() > BLOCKSIZE ? _text.size() : BLOCKSIZE;
+        session->blocks.emplace_back(new char[session->size]);
+        session->ids.push_back(allocateId(session->blocks.back().get()));
+        session->used = 0;
+    }
+    std::memcpy(session->blocks.back().get() + session->used, _text.data(), _text.size());
+    _source = session->ids.back();
+    _offset = static_cast<std::uint32_t>(session->used);
+    session->used += _text.size();
+}
+
+std::uint16_t TextStorage::generation(std::uint16_t _source)
+{
+    return generations[_source].load(std::memory_order_acquire);
+}
+
+std::string_view TextStorage::view(std::uint16_t _source, std::uint32_t _offset, std::uint32_t _length)
+{
+    if (_length == 0)
+        return std::string_view();
+    const Interner* table = symbols[_source].load(std::memory_order_acquire);
+    if (table)
+        return table->spelling(_offset);
+    return std::string_view(bases[_source].load(std::memory_order_acquire) + _offset, _length);
+}
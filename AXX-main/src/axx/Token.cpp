@@ -1,41 +1,122 @@
 #include <axx/token/Token.hpp>
-#include <unordered_set>
+#include <axx/token/TextStorage.hpp>
+#include <axx/token/LineIndex.hpp>
+#include <stdexcept>
 
-std::string Token::getValue() const
+std::string_view Token::getValue() const
 {
-    return value;
+#ifndef NDEBUG
+    if (TextStorage::generation(source) != sourceGeneration)
+        throw std::logic_error("Token text was released with its session");
+#endif
+    return TextStorage::view(source, offset, length);
 }
 
 Type Token::getType() const
 {
-    return type;
+    return static_cast<Type>(type);
+}
+
+const LineIndex* Token::lineIndex() const
+{
+#ifndef NDEBUG
+    if (LineIndex::generation(lines) != linesGeneration)
+        throw std::logic_error("Token line index was released with its source");
+#endif
+    return LineIndex::find(lines);
 }
 
 unsigned int Token::getPos() const
 {
+    const LineIndex* index = lineIndex();
+    if (!index)
+        return 0;
+    unsigned int row, pos;
+    index->resolve(place, row, pos);
     return pos;
 }
 
 unsigned int Token::getRow() const
 {
+    const LineIndex* index = lineIndex();
+    if (!index)
+        return 0;
+    unsigned int row, pos;
+    index->resolve(place, row, pos);
     return row;
 }
 
-void Token::setValue(std::string _value)
+std::uint32_t Token::getPlace() const
+{
+    return place;
+}
+
+std::uint16_t Token::getSource() const
+{
+    return source;
+}
+
+std::uint32_t Token::getSymbol() const
+{
+    return offset;
+}
+
+std::uint32_t Token::checked(std::size_t _length)
+{
+    if (_length > MAXLENGTH)
+        throw std::length_error("Token is longer than 16 MiB");
+    return static_cast<std::uint32_t>(_length);
+}
+
+// Поколение области на момент, когда токен её получил
+void Token::remember()
 {
-    this->value = _value;
+#ifndef NDEBUG
+    this->sourceGeneration = TextStorage::generation(this->source);
+#endif
+}
+
+void Token::setSymbol(std::uint16_t _area, std::uint32_t _symbol, std::uint32_t _length)
+{
+    this->source = _area;
+    this->offset = _symbol;
+    this->length = checked(_length);
+    remember();
+}
+
+void Token::setValue(std::string_view _value)
+{
+    this->length = checked(_value.size());
+    TextStorage::store(_value, this->source, this->offset);
+    remember();
 }
 
 void Token::setType(Type _type)
 {
-    this->type = _type;
+    this->type = static_cast<std::uint8_t>(_type);
+}
+
+Token::Token(std::string_view _value, Type _type, std::uint16_t _lines, std::uint32_t _place)
+    : length(0), type(static_cast<std::uint8_t>(_type)), place(_place), lines(_lines)
+{
+#ifndef NDEBUG
+    this->linesGeneration = LineIndex::generation(_lines);
+#endif
+    setValue(_value);
 }
 
-Token::Token(std::string _value, Type _type, unsigned int _row, unsigned int _pos) : value(_value), type(_type), row(_row), pos(_pos) {}
+Token::Token(Type _type, std::uint16_t _source, std::uint32_t _offset, std::uint32_t _length, std::uint16_t _lines, std::uint32_t _place)
+    : offset(_offset), length(checked(_length)), type(static_cast<std::uint8_t>(_type)), place(_place), source(_source), lines(_lines)
+{
+#ifndef NDEBUG
+    this->linesGeneration = LineIndex::generation(_lines);
+#endif
+    remember();
+}
 
 bool Token::operator==(const Token& _other) const
 {
-    return this->type == _other.getType() && this->value == _other.getValue();
+    return this->getType() == _other.getType() && this->getValue() == _other.getValue();
 }
 
 std::string type_to_str(Type type) {
@@ -0,0 +1,46 @@
+#include <axx/semantic/TypeTable.hpp>
+
+TypeTable::TypeTable(Interner& _interner)
+{
+    // Порядок совпадает с постоянными номерами встроенных типов
+    for (auto name : {"void", "Bool", "Integer", "Float", "String"})
+    {
+        named(_interner.intern(name));
+    }
+}
+
+std::pair<type_t, bool> TypeTable::named(symbol_t _name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto result = names.insert({_name, static_cast<type_t>(descriptors.size())});
+    if (result.second)
+    {
+        descriptors.push_back({Named, _name, NOTYPE, 0});
+    }
+    return {result.first->second, result.second};
+}
+
+type_t TypeTable::find(symbol_t _name) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto type = names.find(_name);
+    return type == names.end() ? NOTYPE : type->second;
+}
+
+type_t TypeTable::array(type_t _element, std::uint32_t _size)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::uint64_t key = (std::uint64_t(_element) << 32) | _size;
+    auto result = arrays.insert({key, static_cast<type_t>(descriptors.size())});
+    if (result.second)
+    {
+        descriptors.push_back({Array, 0, _element, _size});
+    }
+    return result.first->second;
+}
+
+TypeTable::Descriptor TypeTable::describe(type_t _type) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return descriptors.at(_type);
+}
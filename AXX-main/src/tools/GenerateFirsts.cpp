@@ -0,0 +1,200 @@
+// Строит множества FIRST для правил грамматики из Грамматика.txt и записывает их в заголовок для парсера.
+// Запуск: GenerateFirsts <грамматика> <выходной .hpp>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Альтернатива правила: последовательность символов, символ - список вариантов ("(NUMBER | ID)")
+    typedef std::vector<std::vector<std::string>> production_t;
+
+    struct Rule
+    {
+        std::string name;
+        std::vector<production_t> productions;
+    };
+
+    bool isTerminal(const std::string& _symbol)
+    {
+        return std::isupper(static_cast<unsigned char>(_symbol[0]));
+    }
+
+    // Имя терминала в enum Type
+    std::string typeName(const std::string& _terminal)
+    {
+        static const std::map<std::string, std::string> renamed = {{"AND", "andop"}, {"OR", "orop"}, {"XOR", "xorop"}};
+        auto it = renamed.find(_terminal);
+        if (it != renamed.end())
+            return it->second;
+        std::string name = _terminal;
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+        return name;
+    }
+
+    production_t parseProduction(const std::string& _text)
+    {
+        // Скобки и | внутри скобок отделяются пробелами, чтобы разбить строку по словам
+        std::string spaced;
+        for (char c : _text)
+        {
+            if (c == '(' || c == ')' || c == '|')
+                spaced += std::string(" ") + c + " ";
+            else
+                spaced += c;
+        }
+        production_t production;
+        std::istringstream words(spaced);
+        std::string word;
+        bool group = false;
+        while (words >> word)
+        {
+            if (word == "(")
+            {
+                group = true;
+                production.emplace_back();
+            }
+            else if (word == ")")
+                group = false;
+            else if (word == "|")
+                continue;
+            else if (group)
+                production.back().push_back(word);
+            else
+                production.push_back({word});
+        }
+        return production;
+    }
+
+    std::vector<Rule> readGrammar(std::istream& _input)
+    {
+        std::vector<Rule> rules;
+        std::string line;
+        while (std::getline(_input, line))
+        {
+            auto begin = line.find_first_not_of(" \t\r");
+            if (begin == std::string::npos || line[begin] == '#')
+                continue;
+            auto end = line.find_last_not_of(" \t\r");
+            std::string text = line.substr(begin, end - begin + 1);
+            if (text[0] == '|')
+            {
+                if (rules.empty())
+                    throw std::runtime_error("Production without rule: " + text);
+                rules.back().productions.push_back(parseProduction(text.substr(1)));
+            }
+            else if (text.back() == ':')
+                rules.push_back({text.substr(0, text.size() - 1), {}});
+            else
+                throw std::runtime_error("Unexpected line: " + text);
+        }
+        return rules;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <grammar> <output>\n";
+        return 1;
+    }
+    try
+    {
+        std::ifstream input(argv[1]);
+        if (!input)
+            throw std::runtime_error(std::string("Can't open ") + argv[1]);
+        std::vector<Rule> rules = readGrammar(input);
+
+        std::map<std::string, std::set<std::string>> firsts;
+        std::set<std::string> nullable;
+        for (const Rule& rule : rules)
+            firsts[rule.name];
+        for (const Rule& rule : rules)
+            for (const production_t& production : rule.productions)
+                for (const auto& symbol : production)
+                    for (const std::string& variant : symbol)
+                        if (!isTerminal(variant) && !firsts.count(variant))
+                            throw std::runtime_error("Unknown rule " + variant + " in " + rule.name);
+
+        // Множества расширяются, пока меняются
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (const Rule& rule : rules)
+            {
+                std::set<std::string>& first = firsts[rule.name];
+                for (const production_t& production : rule.productions)
+                {
+                    bool empty = true;
+                    for (const auto& symbol : production)
+                    {
+                        bool symbolNullable = false;
+                        for (const std::string& variant : symbol)
+                        {
+                            std::size_t before = first.size();
+                            if (isTerminal(variant))
+                                first.insert(variant);
+                            else
+                            {
+                                first.insert(firsts[variant].begin(), firsts[variant].end());
+                                symbolNullable = symbolNullable || nullable.count(variant);
+                            }
+                            changed = changed || first.size() != before;
+                        }
+                        if (!symbolNullable)
+                        {
+                            empty = false;
+                            break;
+                        }
+                    }
+                    if (empty && nullable.insert(rule.name).second)
+                        changed = true;
+                }
+            }
+        }
+
+        std::ostringstream out;
+        out << "#pragma once\n"
+            << "// Создаётся GenerateFirsts из Грамматика.txt при сборке, не редактировать\n"
+            << "#include <axx/parser/TypeSet.hpp>\n\n"
+            << "/// @brief Правила грамматики\n"
+            << "enum class Rule : std::uint8_t\n{\n";
+        for (const Rule& rule : rules)
+            out << "    " << rule.name << ",\n";
+        out << "};\n\n"
+            << "/// @brief Первые терминалы, которые можно встретить, переходя вглубь правила; индекс - Rule\n"
+            << "constexpr TypeSet FIRSTS[] = {\n";
+        for (const Rule& rule : rules)
+        {
+            out << "    /* " << rule.name << " */ {";
+            bool first = true;
+            for (const std::string& terminal : firsts[rule.name])
+            {
+                out << (first ? "" : ", ") << "Type::" << typeName(terminal);
+                first = false;
+            }
+            out << "},\n";
+        }
+        out << "};\n";
+
+        std::ofstream output(argv[2], std::ios::binary);
+        output << out.str();
+        if (!output)
+            throw std::runtime_error(std::string("Can't write ") + argv[2]);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
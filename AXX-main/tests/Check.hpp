@@ -0,0 +1,54 @@
+#pragma once
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Число нарушенных проверок, его возвращает main теста
+inline int failures = 0;
+
+/// @brief Проверяет условие; при нарушении печатает его и место и продолжает тест
+#define CHECK(_condition)                                                                   \
+    do                                                                                      \
+    {                                                                                       \
+        if (!(_condition))                                                                  \
+        {                                                                                   \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #_condition ") failed\n"; \
+            failures++;                                                                     \
+        }                                                                                   \
+    } while (0)
+
+/// @brief Записывает текст в файл рабочего каталога теста и возвращает путь к нему
+inline std::string write_file(const std::string& _name, const std::string& _text)
+{
+    std::ofstream(_name, std::ios::binary) << _text;
+    return _name;
+}
+
+/// @brief Правильная программа из _count функций, которую проходит семантический анализ;
+/// длинная программа пересекает много порций потока
+inline std::string sample_program(int _count)
+{
+    std::string text;
+    for (int i = 0; i < _count; i++)
+    {
+        std::string n = std::to_string(i);
+        text += "-- subprogram " + n + "\n";
+        text += "function f_" + n + "(left_value: Integer; right_value: Integer) return Integer is\n";
+        text += "    z_1: Integer;\n";
+        text += "    i: Integer;\n";
+        text += "    items: array(1 .. 10) of Integer;\n";
+        text += "begin\n";
+        text += "    z_1 := (left_value + " + n + ") * right_value / 3 - 2 mod 7;\n";
+        text += "    if z_1 > 10 and z_1 /= 12 or not (z_1 < 4) then\n";
+        text += "        z_1 := z_1 - 1;\n";
+        text += "    elsif z_1 = 3 then\n";
+        text += "        Put_Line(\"f_" + n + " = 3\");\n";
+        text += "    else\n";
+        text += "        for i in 1 .. 10 loop z_1 := z_1 + i; end loop;\n";
+        text += "    end if;\n";
+        text += "    while z_1 > 100 loop z_1 := z_1 / 2; end loop;\n";
+        text += "    return z_1;\n";
+        text += "end f_" + n + ";\n";
+    }
+    return text;
+}
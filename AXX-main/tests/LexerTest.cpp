@@ -0,0 +1,198 @@
+#include "Check.hpp"
+#include <axx/lexer/DumpingLexer.hpp>
+#include <axx/lexer/Keywords.hpp>
+#include <axx/lexer/Lexer.hpp>
+#include <axx/lexer/ParallelLexer.hpp>
+#include <axx/lexer/TableLexer.hpp>
+#include <axx/lexer/Scan.hpp>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    // Токены с текстом и местом; число токенов ограничено, чтобы зацикленный лексер не подвесил тест
+    std::vector<Token> tokens(LexerInterface& _lexer)
+    {
+        std::vector<Token> result;
+        do
+        {
+            result.push_back(_lexer.getToken());
+        } while (result.back().getType() != Type::eof && result.size() < 1000000);
+        return result;
+    }
+
+    bool same(const std::vector<Token>& _left, const std::vector<Token>& _right)
+    {
+        if (_left.size() != _right.size())
+            return false;
+        for (std::size_t i = 0; i < _left.size(); i++)
+        {
+            // У eof место зависит от того, где лексер заметил конец текста
+            if (!(_left[i] == _right[i]) || (_left[i].getType() != Type::eof && _left[i].getPlace() != _right[i].getPlace()))
+                return false;
+        }
+        return true;
+    }
+
+    // Оба лексера из потока и из отображённого файла дают одни и те же токены и кончаются eof.
+    // Текст токенов ссылается на файл лексера, поэтому лексеры живут до конца сравнения
+    void engines_agree(const std::string& _text)
+    {
+        Interner interner;
+        std::string path = write_file("lexer_input.ads", _text);
+        std::istringstream lexer_stream(_text), table_stream(_text);
+        Lexer lexer_file(interner), lexer_streamed(interner);
+        TableLexer table_file(interner), table_streamed(interner);
+        lexer_file.open(path);
+        lexer_streamed.open(lexer_stream);
+        table_file.open(path);
+        table_streamed.open(table_stream);
+
+        auto expected = tokens(table_file);
+        CHECK(expected.back().getType() == Type::eof);
+        CHECK(same(tokens(lexer_file), expected));
+        CHECK(same(tokens(lexer_streamed), expected));
+        CHECK(same(tokens(table_streamed), expected));
+    }
+
+    // Файл больше нескольких участков делится между потоками; токены и их места те же, что у
+    // последовательного лексера. Кавычки в символьных литералах и -- в строках не сбивают деление
+    void parallel_agrees()
+    {
+        std::string block = sample_program(1) + "c := '\"'; s := \"it's -- not a comment\"; d := ''';\n";
+        std::string text;
+        while (text.size() < (3u << 20))
+            text += block;
+        Interner interner;
+        std::string path = write_file("parallel_input.ads", text);
+        TableLexer sequential(interner);
+        ParallelLexer parallel(interner, 4);
+        sequential.open(path);
+        parallel.open(path);
+        auto expected = tokens(sequential);
+        CHECK(expected.back().getType() == Type::eof);
+        CHECK(same(tokens(parallel), expected));
+    }
+
+    // Токены в формате print_all_tokens
+    std::string dump(const std::vector<Token>& _tokens)
+    {
+        std::string lines;
+        for (const Token& token : _tokens)
+            lines += type_to_str(token.getType()) + " " + std::string(token.getValue()) + "\n";
+        return lines;
+    }
+
+    // Печать токенов идёт из того же прохода по потоку, что и выдача: поток читается один раз
+    void dumping()
+    {
+        std::string text = sample_program(5);
+        Interner interner;
+        std::istringstream stream(text), copy(text);
+        TableLexer lexer(interner), reference(interner);
+        std::ostringstream printed;
+        DumpingLexer dumping(lexer, printed);
+        dumping.open(stream);
+        reference.open(copy);
+
+        auto result = tokens(dumping);
+        auto expected = tokens(reference);
+        CHECK(same(result, expected));
+        CHECK(printed.str() == dump(expected));
+    }
+
+    // Два подчёркивания подряд в идентификаторе - ошибка: все лексеры выдают unexpected на втором
+    // подчёркивании, как и до блочных ядер, в том числе на границе участков параллельного разбора
+    void double_underscore()
+    {
+        std::string text = "procedure p() is\n    a__b: Integer;\nbegin\n    a__b := 1;\nend p;\n";
+        std::string expected =
+            "procedurekw procedure\nid p\nlpr \nrpr \nis is\nunexpected a_\nid b\ncolon \nid Integer\n"
+            "semicolon \nbeginkw begin\nunexpected a_\nid b\nassign \nnumber 1\nsemicolon \nendkw end\n"
+            "id p\nsemicolon \neof \n";
+        engines_agree(text);
+        Interner interner;
+        std::istringstream stream(text);
+        TableLexer table(interner);
+        table.open(stream);
+        CHECK(dump(tokens(table)) == expected);
+
+        // Имя длиннее блока, чтобы подчёркивания попали в середину блочного просмотра
+        std::string name = std::string(40, 'x') + "__" + std::string(40, 'y');
+        std::string block = text + "    " + name + " := 2;\n";
+        std::string big;
+        while (big.size() < (3u << 20))
+            big += block;
+        std::string path = write_file("underscore_input.ads", big);
+        Lexer lexer(interner);
+        TableLexer sequential(interner);
+        ParallelLexer parallel(interner, 4);
+        lexer.open(path);
+        sequential.open(path);
+        parallel.open(path);
+        auto result = tokens(sequential);
+        CHECK(result.back().getType() == Type::eof);
+        std::size_t unexpected = 0;
+        for (const Token& token : result)
+            unexpected += token.getType() == Type::unexpected;
+        CHECK(unexpected == 3 * (big.size() / block.size()));
+        CHECK(same(tokens(lexer), result));
+        CHECK(same(tokens(parallel), result));
+    }
+
+    // Хеш ключевого слова строится по длине, первому и двум последним символам: слова,
+    // совпадающие с ключевым по этим символам, сравниваются целиком и остаются идентификаторами
+    void keywords()
+    {
+        CHECK(recognize_keyword("begin") == Type::beginkw);
+        CHECK(recognize_keyword("procedure") == Type::procedurekw);
+        CHECK(recognize_keyword("if") == Type::ifkw);
+        CHECK(recognize_keyword("mod") == Type::mod);
+        CHECK(recognize_keyword("xor") == Type::xorop);
+        CHECK(recognize_keyword("bogin") == Type::id);
+        CHECK(recognize_keyword("begi") == Type::id);
+        CHECK(recognize_keyword("procedures") == Type::id);
+        CHECK(recognize_keyword("i") == Type::id);
+        CHECK(recognize_keyword("") == Type::id);
+    }
+}
+
+int main()
+{
+    // Блочные ядра останавливаются на подчёркивании, в том числе за пределами первого блока
+    std::string names = "Put_Line z_1 " + std::string(40, 'a') + "_" + std::string(40, 'B') + "9 ";
+    const char* begin = names.data();
+    const char* end = names.data() + names.size();
+    CHECK(skip_alnum(begin, end) == begin + 3);
+    CHECK(skip_alnum(begin + 4, end) == begin + 8);
+    CHECK(skip_alnum(begin + 9, end) == begin + 10);
+    CHECK(skip_alnum(begin + 13, end) == begin + 53);
+    CHECK(skip_alnum(begin + 54, end) == end - 1);
+    CHECK(skip_blanks(begin + 8, end) == begin + 9);
+    CHECK(find_newline(begin, end) == end);
+
+    keywords();
+    parallel_agrees();
+    dumping();
+    double_underscore();
+
+    engines_agree(sample_program(300));
+    engines_agree("");
+    engines_agree("a := 1; b := a >= 2 and a <= 3 or c /= 4 and 'x' = y.z;");
+    engines_agree("a := 1; -- comment without a newline");
+    // Текст ровно в одну и две порции потока
+    engines_agree(std::string(990, ' ') + "x := 12;\n");
+    engines_agree(std::string(1990, '\n') + "x := 123;\n");
+
+    // После конца текста лексер продолжает отдавать eof
+    Interner interner;
+    std::istringstream stream("x -- tail");
+    Lexer lexer(interner);
+    lexer.open(stream);
+    CHECK(lexer.getToken().getValue() == "x");
+    CHECK(lexer.getToken().getType() == Type::eof);
+    CHECK(lexer.getToken().getType() == Type::eof);
+    return failures;
+}
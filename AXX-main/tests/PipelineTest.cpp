@@ -0,0 +1,581 @@
+#include "Check.hpp"
+#include <axx/AST/ASTArena.hpp>
+#include <axx/AST/FlatAST.hpp>
+#include <axx/lexer/TableLexer.hpp>
+#include <axx/parser/Parser.hpp>
+#include <axx/semantic/SemanticAnalyzer.hpp>
+#include <axx/semantic/SymbolTable.hpp>
+#include <axx/semantic/TypeTable.hpp>
+#include <axx/optimizer/ConstantFolder.hpp>
+#include <axx/codegen/CodeGenerator.hpp>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /// @brief Сеанс трансляции одного текста. Токены в диагностиках и деревьях ссылаются
+    /// на таблицу идентификаторов, поэтому она живёт дольше всего остального
+    struct Session
+    {
+        Interner interner;
+        Diagnostics diagnostics;
+        std::istringstream input;
+        TableLexer lexer;
+        Parser parser;
+
+        Session(const std::string& _text) : input(_text), lexer(interner), parser(diagnostics)
+        {
+            lexer.open(input);
+            parser.setLexer(&lexer);
+        }
+    };
+
+    // Трансляция всего файла, как в main: при ошибках код не выводится
+    std::string translate(Session& _session, unsigned int _threads = 1)
+    {
+        std::unique_ptr<AST> ast(_session.parser.getAST());
+        SemanticAnalyzer(_session.interner, _session.diagnostics, _threads).check(ast.get());
+        if (_session.diagnostics.errorCount() != 0)
+            return "";
+        ConstantFolder(_session.interner).optimize(ast.get());
+        std::ostringstream output;
+        CodeGenerator(output, _session.interner, _threads).generate(ast.get());
+        return output.str();
+    }
+
+    // Трансляция по одной инструкции, как main --streaming: вывод останавливается на первой ошибке
+    std::string stream(Session& _session)
+    {
+        std::ostringstream output;
+        CodeGenerator codegen(output, _session.interner, 1);
+        SemanticAnalyzer seman(_session.interner, _session.diagnostics, 1);
+        ConstantFolder optimizer(_session.interner);
+        codegen.start();
+        while (std::unique_ptr<AST> statement{_session.parser.getNextStatement()})
+        {
+            seman.check(statement.get());
+            if (_session.diagnostics.errorCount() == 0)
+            {
+                optimizer.optimize(statement.get());
+                codegen.generateStatement(statement.get());
+            }
+        }
+        codegen.finish();
+        return output.str();
+    }
+
+    std::string translate(const std::string& _text)
+    {
+        Session session(_text);
+        return translate(session);
+    }
+
+    bool contains(const std::string& _text, const std::string& _part)
+    {
+        return _text.find(_part) != _text.npos;
+    }
+
+    std::string read_file(const std::string& _name)
+    {
+        std::ifstream file(_name, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Выведенный код проверяется тем же компилятором, которым собран транслятор
+    bool compiles(const std::string& _code, const std::string& _name = "generated.cpp")
+    {
+#ifdef AXX_CXX
+        write_file(_name, _code);
+        std::string command = std::string("\"") + AXX_CXX + "\" -std=c++17 -fsyntax-only " + _name;
+        return std::system(command.c_str()) == 0;
+#else
+        return !_code.empty();
+#endif
+    }
+
+    // Выведенный код с добавленной функцией main собирается и запускается; результат - то, что он напечатал
+    std::string run(const std::string& _code, const std::string& _main)
+    {
+#ifdef AXX_CXX
+        write_file("run.cpp", _code + _main);
+        std::string command = std::string("\"") + AXX_CXX + "\" -std=c++17 run.cpp -o run.out && ./run.out > run.txt";
+        if (std::system(command.c_str()) != 0)
+            return "";
+        return read_file("run.txt");
+#else
+        (void)_code;
+        (void)_main;
+        return "";
+#endif
+    }
+
+    // mod в Ada берёт знак делителя: вычисленный при свёртке и выведенный mod дают одно значение
+    void modulo()
+    {
+        std::string code = translate("function f(n: Integer) return Integer is\n    a: Integer;\n    b: Integer;\n"
+                                     "begin\n    a := -7 mod 3;\n    b := -n mod 3;\n    return a * 10 + b;\nend f;\n");
+        CHECK(contains(code, "a = 2;"));
+        CHECK(contains(code, "b = axx_rt::mod(-n, 3);"));
+        CHECK(compiles(code));
+#ifdef AXX_CXX
+        CHECK(run(code, "#include <cstdio>\nint main() { std::printf(\"%d %d\", f(7), f(-7)); }\n") == "22 21");
+#endif
+
+        // Подпрограмма программы с именем, похожим на имя вспомогательной функции, с ней не конфликтует
+        code = translate("function mod_(a: Integer; b: Integer) return Integer is\nbegin\n    return a;\nend mod_;\n"
+                         "function f(x: Integer) return Integer is\nbegin\n    return mod_(x, 3) + x mod 3;\nend f;\n");
+        CHECK(contains(code, "int mod_(int a, int b)"));
+        CHECK(contains(code, "axx_rt::mod(x, 3)"));
+        CHECK(compiles(code));
+    }
+
+    // Свёртка вычисляет константные выражения как Ada; переполнение и деление на ноль остаются
+    // в коде, а and/or с известным операндом упрощаются, не теряя вызовов
+    void folding()
+    {
+        std::string code = translate(
+            "function g(n: Integer) return Integer is\nbegin\n    return n;\nend g;\n"
+            "function f(n: Integer) return Integer is\n"
+            "    a: Integer;\n"
+            "    flag: Bool;\n"
+            "begin\n"
+            "    a := 2 + 3 * 4 - 10 / 3;\n"
+            "    a := -7 / 2;\n"
+            "    a := 2147483647 + 1;\n"
+            "    a := 7 / 0;\n"
+            "    a := 7 mod 0;\n"
+            "    flag := 3 > 2 and n > 1;\n"
+            "    flag := 1 > 2 and n > 1;\n"
+            "    flag := 1 > 2 and g(n) > 1;\n"
+            "    flag := n > 1 or not (1 > 2);\n"
+            "    return a;\n"
+            "end f;\n");
+        CHECK(contains(code, "a = 11;"));
+        CHECK(contains(code, "a = -3;"));
+        CHECK(contains(code, "a = (2147483647 + 1);"));
+        CHECK(contains(code, "a = (7 / 0);"));
+        CHECK(contains(code, "a = axx_rt::mod(7, 0);"));
+        CHECK(contains(code, "flag = (n > 1);"));
+        CHECK(contains(code, "flag = false;"));
+        CHECK(contains(code, "flag = (false && (g(n) > 1));"));
+        CHECK(contains(code, "flag = true;"));
+    }
+
+    // Минус перед унарным выражением и перед отрицательной константой не сливается в --
+    void nested_minus()
+    {
+        std::string code = translate("function f(n: Integer) return Integer is\n    a: Integer;\nbegin\n"
+                                     "    a := -(-2147483647 - 1);\n    a := -(-n);\n    return a;\nend f;\n");
+        CHECK(contains(code, "a = -(-2147483648);"));
+        CHECK(contains(code, "a = -(-n);"));
+        CHECK(compiles(code));
+    }
+
+    // Подпрограмма вызывает описанную ниже: анализ это пропускает, а объявления идут до тел
+    void forward_calls()
+    {
+        Session session("function first(n: Integer) return Integer is\nbegin\n    return second(n);\nend first;\n"
+                        "function second(n: Integer) return Integer is\nbegin\n    return n;\nend second;\n");
+        std::string code = translate(session);
+        CHECK(session.diagnostics.errorCount() == 0);
+        CHECK(code.find("int second(int n);") < code.find("int first(int n)\n"));
+        CHECK(compiles(code));
+    }
+
+    // Выведенное до ошибки доходит до потока; тела совпадают с выводом всего файла
+    void streaming()
+    {
+        std::string text = sample_program(20);
+        Session whole(text), streamed(text);
+        std::string expected = translate(whole);
+        std::string result = stream(streamed);
+        CHECK(!expected.empty());
+        CHECK(result.size() > expected.size() / 2);
+        CHECK(result.substr(result.size() - 2000) == expected.substr(expected.size() - 2000));
+
+        Session broken(text + "procedure bad() is\nbegin\n    q := 1;\nend bad;\n");
+        result = stream(broken);
+        CHECK(broken.diagnostics.errorCount() == 1);
+        CHECK(contains(result, "int f_19(int left_value, int right_value)"));
+        CHECK(!contains(result, "bad"));
+    }
+
+    // String передаётся по константной ссылке, поэтому присваивание параметру - ошибка анализа
+    void parameters()
+    {
+        Session good("procedure greet(s: String; n: Integer) is\n    t: String;\nbegin\n    t := s;\n    Put_Line(t);\nend greet;\n");
+        std::string code = translate(good);
+        CHECK(good.diagnostics.errorCount() == 0);
+        CHECK(contains(code, "void greet(const std::string &s, int n)"));
+        CHECK(compiles(code));
+
+        Session bad("procedure greet(s: String) is\nbegin\n    s := \"x\";\nend greet;\n");
+        CHECK(translate(bad).empty());
+        CHECK(bad.diagnostics.errorCount() == 1);
+        CHECK(bad.diagnostics.all().front().problem == Problem::AssignToParameter);
+    }
+
+    // Синтаксические и семантические ошибки выводятся одним списком по месту в тексте,
+    // и список не зависит от числа потоков анализа
+    void diagnostics_order()
+    {
+        std::string text =
+            "procedure a(q: Integer) is\n"
+            "    t: Integer;\n"
+            "begin\n"
+            "    t := \"x\";\n"
+            "end a;\n"
+            "function b(q: Integer) return Integer is\n"
+            "begin\n"
+            "    return q +* 2;\n"
+            "end b;\n"
+            "procedure c() is\n"
+            "    u: Integer;\n"
+            "begin\n"
+            "    u := missing(1);\n"
+            "    u := b(1, 2);\n"
+            "end c;\n";
+        Session serial(text), parallel(text);
+        translate(serial, 1);
+        translate(parallel, 4);
+
+        auto ordered = serial.diagnostics.ordered();
+        CHECK(ordered.size() == 4);
+        std::vector<unsigned int> rows;
+        for (auto& diagnostic : ordered)
+            rows.push_back(diagnostic.at.getRow());
+        CHECK((rows == std::vector<unsigned int>{4, 8, 13, 14}));
+        CHECK(ordered.size() > 1 && ordered[1].problem == Problem::Syntax);
+
+        std::ostringstream one, four;
+        serial.diagnostics.print(one);
+        parallel.diagnostics.print(four);
+        CHECK(one.str() == four.str());
+    }
+
+    std::size_t syntax_errors(const std::string& _text)
+    {
+        Session session(_text);
+        std::unique_ptr<AST> ast(session.parser.getAST());
+        return session.diagnostics.errorCount();
+    }
+
+    // Выбор правила по множествам FIRST: каждая конструкция грамматики разбирается без ошибок,
+    // а после неверной инструкции разбор продолжается со следующей
+    void first_sets()
+    {
+        std::string body =
+            "    x := (a - 1) * 2;\n"
+            "    flag := not (x > 1) and true or x /= 3;\n"
+            "    if x > 1 then\n"
+            "        Put_Line(\"big\");\n"
+            "    elsif x = 1 then\n"
+            "        x := x - 1;\n"
+            "    else\n"
+            "        x := 0;\n"
+            "    end if;\n"
+            "    for i in 1 .. 3 loop\n"
+            "        x := x + i;\n"
+            "    end loop;\n"
+            "    while x < 10 loop\n"
+            "        x := x + 1;\n"
+            "    end loop;\n"
+            "    p(x, b);\n";
+        std::string head =
+            "procedure p(a: Integer; b: Float) is\n"
+            "    x: Integer;\n"
+            "    flag: Boolean;\n"
+            "    items: array(1 .. 3) of Integer;\n"
+            "begin\n";
+        CHECK(syntax_errors(head + body + "end p;\nprocedure q() is\nbegin\n    q();\nend q;\n") == 0);
+        CHECK(syntax_errors(head + "    ) := 1;\n" + body + "end p;\n") == 1);
+        CHECK(syntax_errors(head + body + "    then x := 1;\nend p;\n") == 1);
+    }
+
+    // Подпрограммы выводятся в нескольких потоках, а результат совпадает с последовательным байт в байт
+    void parallel_codegen()
+    {
+        std::string text = sample_program(40);
+        Session serial(text), parallel(text);
+        std::string expected = translate(serial, 1);
+        CHECK(!expected.empty());
+        CHECK(translate(parallel, 4) == expected);
+    }
+
+    // Подключаются только заголовки, которые нужны выведенному коду
+    void headers()
+    {
+        std::string numbers = translate("function f(n: Integer) return Integer is\nbegin\n    return n + 1;\nend f;\n");
+        CHECK(!contains(numbers, "#include"));
+        CHECK(compiles(numbers));
+
+        std::string strings = translate("procedure p(s: String) is\n    t: String;\nbegin\n    t := s;\nend p;\n");
+        CHECK(contains(strings, "#include <string>\n"));
+        CHECK(!contains(strings, "#include <iostream>"));
+        CHECK(compiles(strings));
+
+        std::string output = translate("procedure p() is\nbegin\n    Put_Line(\"hi\");\nend p;\n");
+        CHECK(contains(output, "#include <string>\n") && contains(output, "#include <iostream>\n"));
+        CHECK(!contains(output, "bits/stdc++.h"));
+        CHECK(compiles(output));
+    }
+
+    // Участки вместе содержат те же тела в том же порядке, что и один файл; каждый участок
+    // компилируется сам с общим заголовком, а неизменившийся файл не перезаписывается
+    void shards()
+    {
+        std::string text = sample_program(12);
+        Session whole(text), sharded(text);
+        std::string expected = translate(whole);
+
+        std::unique_ptr<AST> ast(sharded.parser.getAST());
+        SemanticAnalyzer(sharded.interner, sharded.diagnostics, 1).check(ast.get());
+        ConstantFolder(sharded.interner).optimize(ast.get());
+        CodeGenerator generator(std::cout, sharded.interner, 1);
+        generator.generateShards(ast.get(), "shard", 3);
+
+        std::string header = read_file("shard.hpp");
+        CHECK(contains(header, "int f_11(int left_value, int right_value);"));
+        std::string bodies;
+        bool compiled = true;
+        for (int i = 0; i < 3; i++)
+        {
+            std::string name = "shard_" + std::to_string(i) + ".cpp";
+            std::string code = read_file(name);
+            CHECK(code.find("#include \"shard.hpp\"\n") == 0);
+            CHECK(contains(code, "int f_"));
+            bodies += code.substr(code.find('\n') + 1);
+            compiled = compiled && compiles(code, name);
+        }
+        CHECK(compiled);
+        CHECK(expected.size() > bodies.size() && expected.compare(expected.size() - bodies.size(), bodies.size(), bodies) == 0);
+
+        auto written = std::filesystem::last_write_time("shard_0.cpp");
+        generator.generateShards(ast.get(), "shard", 3);
+        CHECK(std::filesystem::last_write_time("shard_0.cpp") == written);
+    }
+
+    // Буфер отдаёт потоку весь текст по порядку, в том числе фрагменты крупнее себя, и не теряет
+    // остаток при разрушении; буфер без потока только копит текст
+    void output_buffer()
+    {
+        std::string expected;
+        std::ostringstream stream;
+        {
+            OutputBuffer output(stream);
+            for (int i = 0; i < 20000; i++)
+            {
+                std::string piece = "line " + std::to_string(i) + "\n";
+                if (i == 5000)
+                    piece = std::string(200000, 'z');
+                output.append(piece);
+                expected += piece;
+            }
+            CHECK(stream.str().size() < expected.size());
+            CHECK(expected.compare(0, stream.str().size(), stream.str()) == 0);
+        }
+        CHECK(stream.str() == expected);
+
+        OutputBuffer memory;
+        memory.append("int x;\n");
+        memory.flush();
+        memory.append("int y;\n");
+        CHECK(memory.text() == "int x;\nint y;\n");
+    }
+
+    // Каждый тип описан один раз: одинаковые типы получают один номер, встроенные - постоянные номера
+    void type_ids()
+    {
+        Interner interner;
+        TypeTable types(interner);
+        CHECK(types.find(interner.intern("integer")) == TypeTable::INTEGER);
+        CHECK(types.find(interner.intern("String")) == TypeTable::STRING);
+        CHECK(types.find(interner.intern("Matrix")) == TypeTable::NOTYPE);
+
+        auto created = types.named(interner.intern("Matrix"));
+        CHECK(created.second);
+        CHECK(types.named(interner.intern("MATRIX")) == std::make_pair(created.first, false));
+
+        type_t row = types.array(TypeTable::INTEGER, 10);
+        CHECK(types.array(TypeTable::INTEGER, 10) == row);
+        CHECK(types.array(TypeTable::INTEGER, 11) != row);
+        CHECK(types.array(TypeTable::FLOAT, 10) != row);
+        auto descriptor = types.describe(row);
+        CHECK(descriptor.kind == TypeTable::Array && descriptor.element == TypeTable::INTEGER && descriptor.size == 10);
+    }
+
+    // Выход из области убирает её имена и отменяет её изменения; таблица подпрограммы
+    // видит глобальные имена, но не меняет глобальную таблицу
+    void scopes()
+    {
+        Interner interner;
+        symbol_t a = interner.intern("a"), b = interner.intern("b"), c = interner.intern("c");
+        SymbolTable globals;
+        CHECK(globals.insert(a, Symbol(interner.token("a"), TypeTable::INTEGER)));
+
+        SymbolTable local(&globals);
+        local.enter();
+        CHECK(local.insert(b, Symbol(interner.token("b"), TypeTable::STRING)));
+        CHECK(!local.insert(a, Symbol(interner.token("a"), TypeTable::FLOAT)));
+        local.modify(a).type = TypeTable::FLOAT;
+        CHECK(local.find(a)->type == TypeTable::FLOAT);
+        CHECK(globals.find(a)->type == TypeTable::INTEGER);
+
+        local.enter();
+        CHECK(local.insert(c, Symbol(interner.token("c"), TypeTable::BOOL)));
+        local.modify(b).type = TypeTable::INTEGER;
+        local.leave();
+        CHECK(local.find(c) == nullptr);
+        CHECK(local.find(b) && local.find(b)->type == TypeTable::STRING);
+
+        local.leave();
+        CHECK(local.find(b) == nullptr);
+        CHECK(local.find(a) && local.find(a)->type == TypeTable::INTEGER);
+        CHECK(globals.find(b) == nullptr);
+    }
+
+    // Выведенные скобки показывают дерево, которое построил разбор по приоритетам:
+    // старшие операции связываются раньше, операции одного уровня - слева направо
+    void precedence()
+    {
+        std::string code = translate(
+            "function f(a: Integer; b: Integer; c: Integer) return Integer is\n"
+            "    x: Integer;\n"
+            "    flag: Bool;\n"
+            "begin\n"
+            "    x := a + b * c - a;\n"
+            "    x := a - b - c;\n"
+            "    x := (a + b) * c;\n"
+            "    x := a * b / c mod a;\n"
+            "    flag := (a > b and b < c) or not (a = c);\n"
+            "    return x;\n"
+            "end f;\n");
+        CHECK(contains(code, "x = ((a + (b * c)) - a);"));
+        CHECK(contains(code, "x = ((a - b) - c);"));
+        CHECK(contains(code, "x = ((a + b) * c);"));
+        CHECK(contains(code, "x = axx_rt::mod(((a * b) / c), a);"));
+        CHECK(contains(code, "flag = (((a > b) && (b < c)) || !(a == c));"));
+    }
+
+    // Узлы области выровнены и уничтожаются вместе с ней в порядке, обратном созданию;
+    // узел крупнее блока получает свой блок
+    struct alignas(64) Tracked
+    {
+        std::vector<int>& destroyed;
+        int number;
+        Tracked(std::vector<int>& _destroyed, int _number) : destroyed(_destroyed), number(_number) {}
+        ~Tracked()
+        {
+            destroyed.push_back(number);
+        }
+    };
+
+    void arena()
+    {
+        std::vector<int> destroyed;
+        bool aligned = true;
+        {
+            ASTArena arena;
+            for (int i = 0; i < 3000; i++)
+            {
+                Tracked* node = arena.make<Tracked>(destroyed, i);
+                aligned = aligned && reinterpret_cast<std::uintptr_t>(node) % alignof(Tracked) == 0;
+                arena.make<char>('x');
+            }
+            auto* big = arena.make<std::array<char, 100000>>();
+            big->fill('y');
+            CHECK(destroyed.empty());
+        }
+        CHECK(aligned);
+        CHECK(destroyed.size() == 3000);
+        CHECK(!destroyed.empty() && destroyed.front() == 2999 && destroyed.back() == 0);
+    }
+
+    // Обход плоского дерева по массивам: узлы приходят по возрастанию номеров, каждый входит и выходит один раз
+    class Counter : public FlatVisitorInterface
+    {
+    public:
+        std::vector<std::uint32_t> entered;
+        std::size_t left = 0;
+        std::size_t functions = 0;
+        bool skip_bodies = false;
+
+        bool enter(const FlatAST& _tree, std::uint32_t _node) override
+        {
+            entered.push_back(_node);
+            if (_tree.kind(_node) == NodeKind::Function)
+            {
+                functions++;
+                return !skip_bodies;
+            }
+            return true;
+        }
+        void leave(const FlatAST&, std::uint32_t) override
+        {
+            left++;
+        }
+    };
+
+    void flat_tree()
+    {
+        Session session(sample_program(30));
+        std::unique_ptr<AST> ast(session.parser.getAST());
+        FlatAST flat(ast->getRoot());
+
+        Counter all;
+        flat.accept(all);
+        CHECK(all.entered.size() == flat.size());
+        CHECK(all.left == flat.size());
+        bool ordered = true;
+        for (std::uint32_t i = 0; i < all.entered.size(); i++)
+            ordered = ordered && all.entered[i] == i;
+        CHECK(ordered);
+        CHECK(all.functions == 30);
+
+        Counter top;
+        top.skip_bodies = true;
+        flat.accept(top);
+        CHECK(top.functions == 30);
+        CHECK(top.entered.size() == 32); // Программа, 30 функций и eof
+
+        // Копия буфера разворачивается в дерево, из которого выводится тот же код
+        FlatAST copy(flat.data(), flat.bytes());
+        auto expanded = copy.expand();
+        std::ostringstream original, restored;
+        CodeGenerator(original, session.interner, 1).generate(ast.get());
+        CodeGenerator(restored, session.interner, 1).generate(expanded.get());
+        CHECK(original.str() == restored.str());
+    }
+}
+
+int main()
+{
+    streaming();
+    forward_calls();
+    diagnostics_order();
+    parameters();
+    flat_tree();
+    modulo();
+    nested_minus();
+    folding();
+    arena();
+    first_sets();
+    precedence();
+    scopes();
+    type_ids();
+    output_buffer();
+    parallel_codegen();
+    shards();
+    headers();
+    return failures;
+}
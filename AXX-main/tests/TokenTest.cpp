@@ -0,0 +1,232 @@
+#include "Check.hpp"
+#include <axx/token/Interner.hpp>
+#include <axx/token/LineIndex.hpp>
+#include <axx/token/TextStorage.hpp>
+#include <axx/token/Token.hpp>
+#include <axx/token/TokenRing.hpp>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Блоки текста и их номера освобождаются вместе с сеансом, а не копятся до конца программы
+    void sessions_release_text()
+    {
+        std::string big(70000, 'x');
+        std::uint16_t highest = 0;
+        for (int i = 0; i < 1000; i++)
+        {
+            Interner interner;
+            Token literal(big, Type::string);
+            Token small("Put_Line", Type::string);
+            CHECK(literal.getValue() == big);
+            CHECK(small.getValue() == "Put_Line");
+            CHECK(interner.spelling(interner.intern("Put_Line")) == "Put_Line");
+            highest = std::max({highest, literal.getSource(), small.getSource(), interner.getArea()});
+        }
+        CHECK(highest < 16);
+    }
+
+    // Номера областей освободившегося сеанса достаются следующему. Токен, переживший свой сеанс,
+    // в отладочной сборке бросает исключение, а не читает текст нового сеанса
+    void stale_tokens_fail()
+    {
+#ifndef NDEBUG
+        auto old = std::make_unique<Interner>();
+        Token name = old->token("Old_Name");
+        Token literal("old text", Type::string);
+        old.reset();
+        Interner fresh;
+        Token current = fresh.token("New_Name");
+        Token text("new text", Type::string);
+        CHECK(current.getValue() == "New_Name");
+        CHECK(text.getValue() == "new text");
+        for (const Token& stale : {name, literal})
+        {
+            bool thrown = false;
+            try
+            {
+                stale.getValue();
+            }
+            catch (const std::logic_error&)
+            {
+                thrown = true;
+            }
+            CHECK(thrown);
+        }
+#endif
+    }
+
+    // Написания таблицы принадлежат ей, даже если после неё создана другая таблица
+    void spellings_belong_to_their_table()
+    {
+        Interner outer;
+        symbol_t symbol;
+        {
+            auto inner = std::make_unique<Interner>();
+            symbol = outer.intern("Outer_Name");
+            inner->intern("inner_name");
+        }
+        CHECK(outer.spelling(symbol) == "Outer_Name");
+        CHECK(outer.intern("OUTER_NAME") == symbol);
+    }
+
+    // Номера плотные и не зависят от регистра; токен с тем же написанием получает тот же номер,
+    // и номера сохраняются при росте таблицы
+    void interning()
+    {
+        Interner interner;
+        symbol_t first = interner.intern("Put_Line");
+        CHECK(interner.intern("PUT_LINE") == first);
+        CHECK(interner.spelling(first) == "Put_Line");
+        CHECK(interner.symbol(Token("put_line", Type::id)) == first);
+        CHECK(interner.symbol(interner.token("Other")) == first + 1);
+
+        std::vector<symbol_t> symbols;
+        for (int i = 0; i < 10000; i++)
+            symbols.push_back(interner.intern("name_" + std::to_string(i)));
+        bool stable = true;
+        for (int i = 0; i < 10000; i++)
+            stable = stable && symbols[i] == first + 2 + symbol_t(i) &&
+                     interner.intern("NAME_" + std::to_string(i)) == symbols[i];
+        CHECK(stable);
+    }
+
+    // Потоки добавляют новые имена, пока другие читают написания уже выданных номеров:
+    // рост таблицы не сдвигает прочитанные написания
+    void concurrent_interning()
+    {
+        Interner interner;
+        const int count = 20000;
+        std::vector<symbol_t> first(count);
+        for (int i = 0; i < count; i++)
+            first[i] = interner.intern("first_" + std::to_string(i));
+
+        std::vector<int> broken(8, 0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; t++)
+        {
+            threads.emplace_back([&, t]()
+            {
+                for (int i = 0; i < count; i++)
+                {
+                    if (t % 2 == 0)
+                    {
+                        std::string name = "thread_" + std::to_string(t) + "_" + std::to_string(i);
+                        symbol_t symbol = interner.intern(name);
+                        broken[t] += interner.spelling(symbol) != name;
+                    }
+                    else
+                    {
+                        int j = (i * 7919 + t) % count;
+                        broken[t] += interner.spelling(first[j]) != "first_" + std::to_string(j);
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        CHECK(std::count(broken.begin(), broken.end(), 0) == 8);
+        CHECK(interner.intern("THREAD_6_19999") == interner.intern("thread_6_19999"));
+        CHECK(interner.spelling(first[count - 1]) == "first_" + std::to_string(count - 1));
+    }
+
+    // Очередь проходит через конец памяти кольца, не теряя порядка; переполнение - исключение
+    void token_ring()
+    {
+        TokenRing<4> ring;
+        std::vector<std::string> names = {"a", "bb", "ccc", "dddd", "eeeee", "ffffff", "g"};
+        std::vector<Token> tokens;
+        for (const std::string& name : names)
+            tokens.emplace_back(name, Type::id);
+        std::string order;
+        for (std::size_t i = 0; i < tokens.size(); i++)
+        {
+            ring.push(tokens[i]);
+            if (ring.size() == 3)
+            {
+                CHECK(ring.peek(2) == tokens[i]);
+                order += std::string(ring.pop().getValue()) + " ";
+            }
+        }
+        while (!ring.empty())
+            order += std::string(ring.pop().getValue()) + " ";
+        CHECK(order == "a bb ccc dddd eeeee ffffff g ");
+
+        for (int i = 0; i < 4; i++)
+            ring.emplace("x", Type::id);
+        bool thrown = false;
+        try
+        {
+            ring.push(tokens[0]);
+        }
+        catch (const std::length_error&)
+        {
+            thrown = true;
+        }
+        CHECK(thrown);
+        CHECK(ring.size() == 4);
+        ring.clear();
+        CHECK(ring.empty());
+    }
+
+    // Одновременно открытых таблиц строк может быть больше 256, номера освободившихся используются снова
+    void many_line_indexes()
+    {
+        std::string text = "a\nbb\nccc\n";
+        std::vector<std::unique_ptr<LineIndex>> indexes;
+        for (int i = 0; i < 1000; i++)
+            indexes.emplace_back(new LineIndex(text.data(), text.size()));
+        Token last("ccc", Type::id, indexes.back()->getId(), 5);
+        CHECK(last.getRow() == 3);
+        CHECK(last.getPos() == 1);
+
+        std::uint16_t highest = indexes.back()->getId();
+        indexes.clear();
+        LineIndex again(text.data(), text.size());
+        CHECK(again.getId() <= highest);
+        CHECK(Token("bb", Type::id, again.getId(), 2).getRow() == 2);
+
+        // Токен, переживший таблицу строк, в отладочной сборке не берёт координаты из новой таблицы
+#ifndef NDEBUG
+        bool thrown = false;
+        try
+        {
+            last.getRow();
+        }
+        catch (const std::logic_error&)
+        {
+            thrown = true;
+        }
+        CHECK(thrown);
+#endif
+    }
+
+    void token_layout()
+    {
+        Token token("Put_Line", Type::string, 7, 42);
+        CHECK(token.getType() == Type::string);
+        CHECK(token.getValue() == "Put_Line");
+        CHECK(token.getPlace() == 42);
+        token.setType(Type::unexpected);
+        CHECK(token.getType() == Type::unexpected);
+        CHECK(token.getValue() == "Put_Line");
+    }
+}
+
+int main()
+{
+    interning();
+    token_ring();
+    many_line_indexes();
+    token_layout();
+    sessions_release_text();
+    spellings_belong_to_their_table();
+    stale_tokens_fail();
+    concurrent_interning();
+    return failures;
+}